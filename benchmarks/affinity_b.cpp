@@ -0,0 +1,133 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+
+size_t actors = 4;
+size_t threads = 4;
+size_t messages = 2000;
+size_t state_kb = 1024;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+/// each message walks all cache lines of the state.
+class stateful_actor final : public base_actor {
+public:
+  stateful_actor(actor_affinity affinity, std::atomic_size_t *handled,
+                 std::atomic_size_t *migrations)
+      : _affinity(affinity), _handled(handled), _migrations(migrations),
+        _state(state_kb * 1024 / sizeof(uint64_t), 1) {}
+
+  actor_settings on_init(const actor_settings &base_settings) override {
+    auto result = base_settings;
+    result.affinity = _affinity;
+    return result;
+  }
+
+  void action_handle(const envelope &) override {
+    auto current = std::this_thread::get_id();
+    if (current != _thread) {
+      _thread = current;
+      _migrations->fetch_add(1, std::memory_order_relaxed);
+    }
+    const size_t line = 64 / sizeof(uint64_t);
+    for (size_t i = 0; i < _state.size(); i += line) {
+      _state[i] += _state[(i + line) % _state.size()];
+    }
+    _handled->fetch_add(1, std::memory_order_release);
+  }
+
+private:
+  actor_affinity _affinity;
+  std::atomic_size_t *_handled;
+  std::atomic_size_t *_migrations;
+  std::thread::id _thread;
+  std::vector<uint64_t> _state;
+};
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("affinity", "stateful actors on shared, sticky, own threads");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("a,actors", "Count of actors", cxxopts::value<size_t>(actors));
+  add_o("t,threads", "Count of user threads", cxxopts::value<size_t>(threads));
+  add_o("m,messages", "Count of messages per actor", cxxopts::value<size_t>(messages));
+  add_o("s,state", "State of an actor in KB", cxxopts::value<size_t>(state_kb));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "actors: " << actors << std::endl;
+  std::cout << "threads: " << threads << std::endl;
+  std::cout << "messages: " << messages << std::endl;
+  std::cout << "state: " << state_kb << " KB" << std::endl;
+}
+
+void run(const std::string &name, actor_affinity affinity) {
+  auto params = context::params_t::defparams();
+  params.user_threads = threads;
+  params.user_queue = utils::async::queue_kinds::WORK_STEALING;
+  auto ctx = yaaf::context::make_context(params);
+
+  std::atomic_size_t handled = 0;
+  std::atomic_size_t migrations = 0;
+  std::vector<actor_ref> targets;
+  for (size_t i = 0; i < actors; ++i) {
+    auto addr = ctx->make_actor<stateful_actor>("a" + std::to_string(i), affinity,
+                                                &handled, &migrations);
+    targets.push_back(ctx->get_ref(addr));
+  }
+
+  // actors are idle between messages, so the scheduler chooses a thread each time.
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < messages; ++i) {
+    for (auto &t : targets) {
+      ctx->send(t, int(1));
+    }
+    while (handled.load(std::memory_order_acquire) != (i + 1) * actors) {
+      std::this_thread::yield();
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  ctx->stop();
+
+  std::cout << name << ": " << elapsed / double(messages * actors)
+            << " us/message. migrations: " << migrations.load() - actors << std::endl;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  run("none", actor_affinity::NONE);
+  run("sticky", actor_affinity::STICKY);
+  run("dedicated", actor_affinity::DEDICATED);
+}
@@ -1,6 +1,10 @@
 #include <libyaaf/context.h>
 #include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include <cxxopts.hpp>
 
@@ -8,9 +12,21 @@ using namespace yaaf;
 
 std::atomic_size_t pings = 0;
 std::atomic_size_t pongs = 0;
+size_t payload_bytes = 0;
 
 const std::string PP_ENAME = "ping pong exchange";
 
+using clock_type = std::chrono::steady_clock;
+
+struct ping_message {
+  clock_type::time_point sent;
+  std::string body;
+};
+
+/// publish to receive latencies in microseconds, each 16th delivery.
+std::mutex latencies_locker;
+std::vector<double> latencies;
+
 class pong_actor final : public base_actor {
 public:
   void on_start() override {
@@ -21,10 +37,15 @@ public:
   }
 
   void action_handle(const envelope &e) override {
-    pongs++;
+    if (pongs++ % 16 == 0) {
+      auto sent = e.payload.get<ping_message>().sent;
+      auto latency = std::chrono::duration<double, std::micro>(clock_type::now() - sent);
+      std::lock_guard<std::mutex> lg(latencies_locker);
+      latencies.push_back(latency.count());
+    }
     auto ctx = get_context();
     if (ctx != nullptr) {
-      ctx->send(e.sender, e.payload.cast<int>());
+      ctx->send(e.sender, int(1));
     }
   }
 };
@@ -33,7 +54,7 @@ class ping_actor final : public base_actor {
   size_t _pongs_count;
 
 public:
-  ping_actor() {}
+  ping_actor() : _body(payload_bytes, 'x') {}
 
   void on_start() override {
     auto ctx = get_context();
@@ -49,11 +70,15 @@ public:
   }
 
   void ping(int v) {
+    UNUSED(v);
     auto ctx = get_context();
     if (ctx != nullptr) {
-      ctx->publish(PP_ENAME, v);
+      ctx->publish(PP_ENAME, ping_message{clock_type::now(), _body});
     }
   }
+
+private:
+  std::string _body;
 };
 
 int steps = 10;
@@ -73,6 +98,7 @@ void parse_args(int argc, char **argv) {
   add_o("s,steps", "Steps count", cxxopts::value<int>(steps));
   add_o("o,pongers", "Pongers count", cxxopts::value<size_t>(pongs_count));
   add_o("i,pingers", "Pongers count", cxxopts::value<size_t>(pings_count));
+  add_o("b,bytes", "Payload size", cxxopts::value<size_t>(payload_bytes));
   add_o("u,userspace_threads", "Userspace threads",
         cxxopts::value<size_t>(userspace_threads));
 
@@ -95,6 +121,7 @@ void parse_args(int argc, char **argv) {
 
   std::cout << "pingers: " << pings_count << std::endl;
   std::cout << "pongers: " << pongs_count << std::endl;
+  std::cout << "payload bytes: " << payload_bytes << std::endl;
   std::cout << "steps: " << steps << std::endl;
   std::cout << "userspace threads: " << userspace_threads << std::endl;
 }
@@ -126,12 +153,30 @@ int main(int argc, char **argv) {
 
   for (int i = 0; i < steps; ++i) {
     size_t last_ping = pings.load();
+    size_t last_pong = pongs.load();
+    {
+      std::lock_guard<std::mutex> lg(latencies_locker);
+      latencies.clear();
+    }
 
     std::this_thread::sleep_for(std::chrono::seconds(1));
 
     size_t new_ping = pings.load();
     size_t diff = new_ping - last_ping;
-    std::cout << "#: " << i << " ping-pong speed: " << diff << " per.sec." << std::endl;
-
+    size_t deliveries = pongs.load() - last_pong;
+    std::vector<double> step_latencies;
+    {
+      std::lock_guard<std::mutex> lg(latencies_locker);
+      step_latencies.swap(latencies);
+    }
+    std::sort(step_latencies.begin(), step_latencies.end());
+    std::cout << "#: " << i << " ping-pong speed: " << diff << " per.sec."
+              << " deliveries: " << deliveries << " per.sec.";
+    if (!step_latencies.empty()) {
+      std::cout << " latency p50: " << step_latencies[step_latencies.size() / 2]
+                << " us. p99: " << step_latencies[step_latencies.size() * 99 / 100]
+                << " us.";
+    }
+    std::cout << std::endl;
   }
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+
+std::atomic_bool pong_received = false;
+
+class idle_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override { UNUSED(e); }
+};
+
+class pong_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    UNUSED(e);
+    pong_received.store(true);
+  }
+};
+
+size_t max_idle = 1000000;
+size_t roundtrips = 1000;
+size_t userspace_threads = 1;
+bool use_scan = false;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("idle-actors", "send latency vs count of idle actors");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("m,max_idle", "Max count of idle actors", cxxopts::value<size_t>(max_idle));
+  add_o("r,roundtrips", "Sends per step", cxxopts::value<size_t>(roundtrips));
+  add_o("s,scan", "Use the mailbox scan scheduler");
+  add_o("u,userspace_threads", "Userspace threads",
+        cxxopts::value<size_t>(userspace_threads));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    use_scan = result["scan"].as<bool>();
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "max idle actors: " << max_idle << std::endl;
+  std::cout << "roundtrips: " << roundtrips << std::endl;
+  std::cout << "scheduler: " << (use_scan ? "mailbox scan" : "ready queue") << std::endl;
+  std::cout << "userspace threads: " << userspace_threads << std::endl;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  context::params_t params = context::params_t::defparams();
+  params.user_threads = userspace_threads;
+  params.sys_threads = 1;
+  params.scheduler =
+      use_scan ? scheduler_kinds::MAILBOX_SCAN : scheduler_kinds::READY_QUEUE;
+
+  auto ctx = yaaf::context::make_context(params);
+  auto pong_addr = ctx->make_actor<pong_actor>("pong");
+
+  size_t idle_count = 0;
+  std::vector<double> latencies(roundtrips);
+  for (size_t step = 1000; step <= max_idle; step *= 10) {
+    for (; idle_count < step; ++idle_count) {
+      ctx->make_actor<idle_actor>("idle_" + std::to_string(idle_count));
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    for (size_t i = 0; i < roundtrips; ++i) {
+      pong_received.store(false);
+      auto start = std::chrono::steady_clock::now();
+      ctx->send(pong_addr, int(1));
+      while (!pong_received.load()) {
+        std::this_thread::yield();
+      }
+      auto stop = std::chrono::steady_clock::now();
+      latencies[i] = std::chrono::duration<double, std::micro>(stop - start).count();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double summ = 0;
+    for (auto v : latencies) {
+      summ += v;
+    }
+    std::cout << "idle: " << idle_count << " latency avg: " << summ / roundtrips
+              << " us. p99: " << latencies[roundtrips * 99 / 100] << " us." << std::endl;
+  }
+}
@@ -0,0 +1,124 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+
+std::atomic<std::chrono::steady_clock::time_point::rep> received_at{0};
+
+class target_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    UNUSED(e);
+    received_at.store(std::chrono::steady_clock::now().time_since_epoch().count());
+  }
+};
+
+size_t idle_ms = 1000;
+size_t samples = 50;
+size_t idle_spins = context::params_t::defparams().idle_spins;
+size_t idle_park_us = context::params_t::defparams().idle_park_us;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("idle_cpu", "idle cpu usage and wake-up latency");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("i,idle", "Idle time in milliseconds", cxxopts::value<size_t>(idle_ms));
+  add_o("s,samples", "Count of wake-ups", cxxopts::value<size_t>(samples));
+  add_o("spins", "context::params_t::idle_spins", cxxopts::value<size_t>(idle_spins));
+  add_o("park", "context::params_t::idle_park_us, 0 - busy loop",
+        cxxopts::value<size_t>(idle_park_us));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "idle: " << idle_ms << " ms" << std::endl;
+  std::cout << "samples: " << samples << std::endl;
+  std::cout << "idle spins: " << idle_spins << std::endl;
+  std::cout << "idle park: " << idle_park_us << " us" << std::endl;
+}
+
+/// microseconds from 'start' to the receive by the target.
+template <class F> double wake_up_latency(F &&send) {
+  // the system thread falls asleep.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  received_at.store(0);
+  auto start = std::chrono::steady_clock::now();
+  send();
+  while (received_at.load() == 0) {
+    std::this_thread::yield();
+  }
+  auto stop = std::chrono::steady_clock::time_point(
+      std::chrono::steady_clock::duration(received_at.load()));
+  return std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+void print_latency(const std::string &name, std::vector<double> &l) {
+  std::sort(l.begin(), l.end());
+  std::cout << name << " wake-up latency p50: " << l[l.size() / 2]
+            << " us. p99: " << l[l.size() * 99 / 100] << " us. max: " << l.back()
+            << " us." << std::endl;
+}
+
+void run(scheduler_kinds scheduler, const std::string &name) {
+  context::params_t params = context::params_t::defparams();
+  params.scheduler = scheduler;
+  params.idle_spins = idle_spins;
+  params.idle_park_us = idle_park_us;
+
+  auto ctx = yaaf::context::make_context(params);
+  auto target = ctx->make_actor<target_actor>("target");
+
+  auto cpu_start = std::clock();
+  std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+  auto cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  std::cout << name << " idle cpu: " << 100.0 * cpu * 1000.0 / double(idle_ms) << " %"
+            << std::endl;
+
+  std::vector<double> sends, timers;
+  for (size_t i = 0; i < samples; ++i) {
+    sends.push_back(wake_up_latency([&]() { ctx->send(target, int(1)); }));
+    timers.push_back(wake_up_latency(
+        [&]() { ctx->schedule_once(target, std::chrono::milliseconds(0), int(1)); }));
+  }
+  print_latency(name + " send", sends);
+  print_latency(name + " timer", timers);
+  ctx->stop();
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  run(scheduler_kinds::READY_QUEUE, "ready queue");
+  run(scheduler_kinds::MAILBOX_SCAN, "mailbox scan");
+}
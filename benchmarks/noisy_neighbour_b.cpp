@@ -0,0 +1,137 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+
+std::atomic_bool pong_received = false;
+std::atomic_size_t noisy_handled = 0;
+
+size_t burst = 10000;
+size_t roundtrips = 200;
+size_t work_us = 1;
+size_t throughput = 64;
+size_t userspace_threads = 1;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+class noisy_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    UNUSED(e);
+    auto stop = std::chrono::steady_clock::now() + std::chrono::microseconds(work_us);
+    while (std::chrono::steady_clock::now() < stop) {
+    }
+    noisy_handled.fetch_add(1);
+  }
+};
+
+class quiet_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    UNUSED(e);
+    pong_received.store(true);
+  }
+};
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("noisy-neighbour",
+                           "latency of a quiet actor near a flooded actor");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("b,burst", "Messages to the noisy actor per roundtrip",
+        cxxopts::value<size_t>(burst));
+  add_o("r,roundtrips", "Count of roundtrips", cxxopts::value<size_t>(roundtrips));
+  add_o("w,work", "Work per message of the noisy actor in us",
+        cxxopts::value<size_t>(work_us));
+  add_o("t,throughput", "Quota of messages per apply", cxxopts::value<size_t>(throughput));
+  add_o("u,userspace_threads", "Userspace threads",
+        cxxopts::value<size_t>(userspace_threads));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "burst: " << burst << std::endl;
+  std::cout << "roundtrips: " << roundtrips << std::endl;
+  std::cout << "work: " << work_us << " us" << std::endl;
+  std::cout << "throughput: " << throughput << std::endl;
+  std::cout << "userspace threads: " << userspace_threads << std::endl;
+}
+
+void run(size_t quota) {
+  context::params_t params = context::params_t::defparams();
+  params.user_threads = userspace_threads;
+  params.sys_threads = 1;
+  params.actor_throughput = quota;
+
+  auto ctx = yaaf::context::make_context(params);
+  auto noisy_addr = ctx->make_actor<noisy_actor>("noisy");
+  auto quiet_addr = ctx->make_actor<quiet_actor>("quiet");
+  noisy_handled.store(0);
+
+  std::vector<double> latencies(roundtrips);
+  size_t sent = 0;
+  for (size_t i = 0; i < roundtrips; ++i) {
+    for (size_t j = 0; j < burst; ++j) {
+      ctx->send(noisy_addr, int(1));
+    }
+    sent += burst;
+
+    pong_received.store(false);
+    auto start = std::chrono::steady_clock::now();
+    ctx->send(quiet_addr, int(1));
+    while (!pong_received.load()) {
+      std::this_thread::yield();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    latencies[i] = std::chrono::duration<double, std::micro>(stop - start).count();
+
+    // the noisy actor must not pile up messages from all roundtrips.
+    while (noisy_handled.load() < sent) {
+      std::this_thread::yield();
+    }
+  }
+  ctx->stop();
+
+  std::sort(latencies.begin(), latencies.end());
+  double summ = 0;
+  for (auto v : latencies) {
+    summ += v;
+  }
+  std::cout << "throughput: " << (quota == 0 ? std::string("unlimited") : std::to_string(quota))
+            << " latency avg: " << summ / roundtrips
+            << " us. p50: " << latencies[roundtrips / 2]
+            << " us. p99: " << latencies[roundtrips * 99 / 100] << " us." << std::endl;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  run(0);
+  run(throughput);
+}
@@ -0,0 +1,142 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+using clock_type = std::chrono::steady_clock;
+
+struct control_message {
+  clock_type::time_point sent;
+};
+
+size_t backlog = 100000;
+size_t controls = 50;
+size_t work_ns = 1000;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+/// busy user lane: each user message costs 'work_ns', control messages are timed.
+class worker_actor final : public base_actor {
+public:
+  worker_actor(size_t lanes, std::atomic_size_t *handled, std::vector<double> *latencies)
+      : _lanes(lanes), _handled(handled), _latencies(latencies) {}
+
+  actor_settings on_init(const actor_settings &base_settings) override {
+    auto result = base_settings;
+    result.priority_lanes = _lanes;
+    return result;
+  }
+
+  void action_handle(const envelope &e) override {
+    if (e.payload.is<control_message>()) {
+      auto sent = e.payload.get<control_message>().sent;
+      _latencies->push_back(
+          std::chrono::duration<double, std::micro>(clock_type::now() - sent).count());
+      return;
+    }
+    auto until = clock_type::now() + std::chrono::nanoseconds(work_ns);
+    while (clock_type::now() < until) {
+    }
+    _handled->fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  size_t _lanes;
+  std::atomic_size_t *_handled;
+  std::vector<double> *_latencies;
+};
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("priority", "control message latency under a busy user lane");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("b,backlog", "Count of queued user messages", cxxopts::value<size_t>(backlog));
+  add_o("c,controls", "Count of control messages", cxxopts::value<size_t>(controls));
+  add_o("w,work", "Cost of a user message in ns", cxxopts::value<size_t>(work_ns));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "backlog: " << backlog << std::endl;
+  std::cout << "controls: " << controls << std::endl;
+  std::cout << "work: " << work_ns << " ns" << std::endl;
+}
+
+void run(size_t lanes) {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_size_t handled = 0;
+  std::vector<double> latencies;
+  latencies.reserve(controls);
+  auto target = ctx->make_actor<worker_actor>("worker", lanes, &handled, &latencies);
+
+  std::atomic_bool stop_flag = false;
+  std::atomic_size_t sent = 0;
+  // keeps the user lane saturated.
+  std::thread flooder([&]() {
+    while (!stop_flag.load(std::memory_order_relaxed)) {
+      if (sent.load(std::memory_order_relaxed) >
+          handled.load(std::memory_order_relaxed) + backlog) {
+        std::this_thread::yield();
+        continue;
+      }
+      ctx->send(target, int(1));
+      sent.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  while (sent.load() < backlog) {
+    std::this_thread::yield();
+  }
+  for (size_t i = 0; i < controls; ++i) {
+    ctx->send(target, control_message{clock_type::now()}, system_priority);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  stop_flag = true;
+  flooder.join();
+  // the last control messages wait behind the backlog without lanes.
+  while (handled.load() != sent.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ctx->stop();
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "lanes: " << lanes << ". control latency p50: "
+            << latencies[latencies.size() / 2]
+            << " us. p99: " << latencies[latencies.size() * 99 / 100]
+            << " us. max: " << latencies.back()
+            << " us. user messages: " << handled.load() << std::endl;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  run(0);
+  run(2);
+}
@@ -0,0 +1,146 @@
+#include <libyaaf/context.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+using namespace yaaf;
+
+std::atomic_size_t received = 0;
+
+class spawned_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override { UNUSED(e); }
+};
+
+class target_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    UNUSED(e);
+    received.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+size_t spawns = 1000000;
+size_t senders = 8;
+size_t targets = 8;
+size_t userspace_threads = 1;
+yaaf::utils::logging::abstract_logger *_raw_logger_ptr = nullptr;
+
+void parse_args(int argc, char **argv) {
+  cxxopts::Options options("spawn", "send latency while actors are spawned");
+  options.allow_unrecognised_options();
+  options.positional_help("[optional args]").show_positional_help();
+
+  auto add_o = options.add_options();
+  add_o("v,verbose", "Enable debugging");
+  add_o("h,help", "Help");
+  add_o("c,count", "Count of spawned actors", cxxopts::value<size_t>(spawns));
+  add_o("s,senders", "Count of sending threads", cxxopts::value<size_t>(senders));
+  add_o("t,targets", "Count of target actors", cxxopts::value<size_t>(targets));
+  add_o("u,userspace_threads", "Userspace threads",
+        cxxopts::value<size_t>(userspace_threads));
+
+  try {
+    cxxopts::ParseResult result = options.parse(argc, argv);
+
+    if (result["help"].as<bool>()) {
+      std::cout << options.help() << std::endl;
+      std::exit(0);
+    }
+
+    if (result["verbose"].as<bool>()) {
+      _raw_logger_ptr = new yaaf::utils::logging::console_logger();
+    } else {
+      _raw_logger_ptr = new yaaf::utils::logging::quiet_logger();
+    }
+  } catch (cxxopts::OptionException &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  std::cout << "spawns: " << spawns << std::endl;
+  std::cout << "senders: " << senders << std::endl;
+  std::cout << "targets: " << targets << std::endl;
+  std::cout << "userspace threads: " << userspace_threads << std::endl;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  auto _logger = yaaf::utils::logging::abstract_logger_ptr{_raw_logger_ptr};
+  yaaf::utils::logging::logger_manager::start(_logger);
+
+  context::params_t params = context::params_t::defparams();
+  params.user_threads = userspace_threads;
+  params.sys_threads = 1;
+
+  auto ctx = yaaf::context::make_context(params);
+  std::vector<actor_address> target_addrs(targets);
+  for (size_t i = 0; i < targets; ++i) {
+    target_addrs[i] = ctx->make_actor<target_actor>("target_" + std::to_string(i));
+  }
+
+  std::atomic_bool stop_flag = false;
+  std::atomic_size_t sent = 0;
+  // each sender keeps latencies of each 64th send.
+  std::vector<std::vector<double>> latencies(senders);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < senders; ++i) {
+    threads.emplace_back([&, i]() {
+      size_t n = 0;
+      while (!stop_flag.load(std::memory_order_relaxed)) {
+        auto &target = target_addrs[(i + n) % target_addrs.size()];
+        if (n % 64 == 0) {
+          auto start = std::chrono::steady_clock::now();
+          ctx->send(target, int(1));
+          auto stop = std::chrono::steady_clock::now();
+          latencies[i].push_back(
+              std::chrono::duration<double, std::micro>(stop - start).count());
+        } else {
+          ctx->send(target, int(1));
+        }
+        ++n;
+        // targets must not pile up too many messages.
+        while (sent.load(std::memory_order_relaxed) >
+                   received.load(std::memory_order_relaxed) + 100000 &&
+               !stop_flag.load(std::memory_order_relaxed)) {
+          std::this_thread::yield();
+        }
+        sent.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < spawns; ++i) {
+    ctx->make_actor<spawned_actor>("spawned_" + std::to_string(i));
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  auto sent_while_spawn = sent.load();
+
+  stop_flag.store(true);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  std::vector<double> all;
+  for (auto &l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+
+  std::cout << "spawn speed: " << spawns / elapsed.count() << " actors per second"
+            << std::endl;
+  std::cout << "send speed: " << sent_while_spawn / elapsed.count()
+            << " messages per second" << std::endl;
+  if (!all.empty()) {
+    std::cout << "send latency p50: " << all[all.size() / 2]
+              << " us. p99: " << all[all.size() * 99 / 100]
+              << " us. max: " << all.back() << " us." << std::endl;
+  }
+  ctx->stop();
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <libyaaf/actor_ref.h>
+#include <libyaaf/ask.h>
 #include <libyaaf/envelope.h>
 #include <libyaaf/exports.h>
+#include <libyaaf/timing_wheel.h>
+#include <chrono>
 #include <string>
 
 namespace yaaf {
@@ -29,28 +33,110 @@ public:
   }
 
   template <class T> void send(const actor_address &target, T &&t) {
-    envelope e;
-    e.payload = std::forward<T>(t);
-    send_envelope(target, e);
+    send_envelope(target, envelope{payload_t(std::forward<T>(t)), actor_address()});
+  }
+
+  template <class T> void send(const actor_ref &target, T &&t) {
+    send_envelope(target, envelope{payload_t(std::forward<T>(t)), actor_address()});
+  }
+
+  /// a send to a lane of a priority mailbox, system_priority - for control messages.
+  template <class T>
+  void send(const actor_address &target, T &&t, uint8_t priority) {
+    send_envelope(target,
+                  envelope{payload_t(std::forward<T>(t)), actor_address(), 0, priority});
+  }
+
+  template <class T> void send(const actor_ref &target, T &&t, uint8_t priority) {
+    send_envelope(target,
+                  envelope{payload_t(std::forward<T>(t)), actor_address(), 0, priority});
+  }
+
+  /// sends a request, the target answers by reply().
+  template <class REPLY, class T>
+  ask_future<REPLY> ask(const actor_address &target, T &&t,
+                        std::chrono::milliseconds timeout) {
+    return ask_future<REPLY>(ask_envelope(
+        target, envelope{payload_t(std::forward<T>(t)), actor_address()}, timeout,
+        nullptr));
+  }
+
+  /// f(const REPLY *reply) is called once, reply is nullptr on the timeout.
+  /// for an actor the reply comes to its mailbox and f is called on its turn,
+  /// so f may touch the state of the actor. otherwise f is called from the thread
+  /// of the replier or from a system thread.
+  template <class REPLY, class T, class F>
+  void ask(const actor_address &target, T &&t, std::chrono::milliseconds timeout,
+           F &&f) {
+    inner::ask_callback cb = [f = std::forward<F>(f)](inner::ask_status status,
+                                                      const payload_t &reply) {
+      if (status == inner::ask_status::REPLIED && !reply.empty() &&
+          reply.is<REPLY>()) {
+        f(&reply.get<REPLY>());
+      } else {
+        f(static_cast<const REPLY *>(nullptr));
+      }
+    };
+    ask_envelope(target, envelope{payload_t(std::forward<T>(t)), actor_address()},
+                 timeout, std::move(cb));
+  }
+
+  /// answers to a request of ask(). for a usual message sends t to the sender.
+  template <class T> void reply(const envelope &request, T &&t) {
+    reply_envelope(request, envelope{payload_t(std::forward<T>(t)), actor_address()});
+  }
+
+  /// delivers t to the target after the delay.
+  template <class T>
+  timer_handle schedule_once(const actor_address &target,
+                             std::chrono::microseconds delay, T &&t) {
+    return schedule_envelope(target,
+                             envelope{payload_t(std::forward<T>(t)), actor_address()},
+                             delay, std::chrono::microseconds(0));
+  }
+
+  /// delivers t to the target after the delay and then each period,
+  /// until cancel_timer() or stop of the target.
+  template <class T>
+  timer_handle schedule_periodic(const actor_address &target,
+                                 std::chrono::microseconds delay,
+                                 std::chrono::microseconds period, T &&t) {
+    return schedule_envelope(target,
+                             envelope{payload_t(std::forward<T>(t)), actor_address()},
+                             delay, period);
   }
 
   template <class T> void publish(const std::string &exchange_name, T &&t) {
     envelope e;
     e.payload = std::forward<T>(t);
-    publish_to_exchange(exchange_name, e);
+    publish_to_exchange(exchange_name, std::move(e));
   }
 
   virtual actor_address add_actor(const std::string &actor_name, const actor_ptr a) = 0;
   virtual void send_envelope(const actor_address &target, const envelope &e) = 0;
-  virtual void send_envelope(const actor_address &target, const envelope &&e) = 0;
+  virtual void send_envelope(const actor_address &target, envelope &&e) = 0;
+  virtual void send_envelope(const actor_ref &target, const envelope &e) = 0;
+  virtual void send_envelope(const actor_ref &target, envelope &&e) = 0;
+  virtual inner::ask_ptr ask_envelope(const actor_address &target, envelope &&e,
+                                      std::chrono::milliseconds timeout,
+                                      inner::ask_callback cb) = 0;
+  virtual void reply_envelope(const envelope &request, envelope &&e) = 0;
+  virtual timer_handle schedule_envelope(const actor_address &target, envelope &&e,
+                                         std::chrono::microseconds delay,
+                                         std::chrono::microseconds period) = 0;
+  /// false if the timer is already fired or cancelled.
+  virtual bool cancel_timer(timer_handle h) = 0;
   virtual void stop_actor(const actor_address &addr) = 0;
   virtual actor_weak get_actor(const actor_address &addr) const = 0;
   virtual actor_weak get_actor(const std::string &name) const = 0;
   virtual actor_address get_address(const std::string &name) const = 0;
+  /// an empty ref if the actor does not exist.
+  virtual actor_ref get_ref(const actor_address &addr) const = 0;
   virtual void create_exchange(const std::string &name) = 0;
   virtual void subscribe_to_exchange(const std::string &name) = 0;
+  virtual void unsubscribe_from_exchange(const std::string &name) = 0;
   virtual void publish_to_exchange(const std::string &exchange, const envelope &e) = 0;
-  virtual void publish_to_exchange(const std::string &exchange, const envelope &&e) = 0;
+  virtual void publish_to_exchange(const std::string &exchange, envelope &&e) = 0;
   virtual bool exchange_exists(const std::string&name)const=0;
   virtual std::string name() const = 0;
 };
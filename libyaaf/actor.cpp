@@ -1,6 +1,9 @@
 #include <libyaaf/abstract_context.h>
 #include <libyaaf/actor.h>
 #include <libyaaf/utils/utils.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 using namespace yaaf;
 
@@ -31,7 +34,7 @@ void base_actor::on_child_stopped(const actor_address &addr,
   UNUSED(reason);
 }
 
-void base_actor::apply(mailbox &mbox) {
+void base_actor::apply(abstract_mailbox &mbox) {
   if (mbox.empty()) {
     update_status(actor_status_kinds::NORMAL);
     reset_busy();
@@ -41,20 +44,60 @@ void base_actor::apply(mailbox &mbox) {
   ENSURE(busy());
 
   auto self = shared_from_this();
+  auto batch_size = std::max(_settings.batch_size, size_t(1));
+  auto quota = _settings.throughput == 0 ? std::numeric_limits<size_t>::max()
+                                         : _settings.throughput;
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  if (_settings.time_quota_us != 0) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::microseconds(_settings.time_quota_us);
+  }
   try {
-    envelope el;
-    while (mbox.try_pop(el)) {
-      action_handle(el);
+    // a mailbox may stay not empty after the quota, the context schedules the actor again.
+    size_t handled = 0;
+    while (handled < quota &&
+           mbox.drain(_batch, std::min(batch_size, quota - handled)) != 0) {
+      _batch_handled = 0;
+      action_handle_batch(envelope_span(_batch));
+      handled += _batch.size();
+      _batch.clear();
+      if (_settings.time_quota_us != 0 && std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
     }
     update_status(actor_status_kinds::NORMAL);
     reset_busy();
   } catch (std::exception &ex) {
+    // the default handler counts handled envelopes (with the failed one).
+    // if a custom batch handler throws, whole batch is dropped.
+    if (_batch_handled != 0) {
+      mbox.push_front(envelope_span(_batch).subspan(_batch_handled));
+    }
+    _batch.clear();
     update_status(actor_status_kinds::WITH_ERROR, ex.what());
     reset_busy();
     throw;
   }
 }
 
+void base_actor::action_handle_batch(envelope_span batch) {
+  for (auto &e : batch) {
+    _batch_handled++;
+    if (!handle_ask_reply(e)) {
+      action_handle(e);
+    }
+  }
+}
+
+bool base_actor::handle_ask_reply(const envelope &e) {
+  if (e.correlation_id == 0 || !e.payload.is<inner::ask_reply>()) {
+    return false;
+  }
+  auto &reply = e.payload.get<inner::ask_reply>();
+  reply.callback(reply.status, reply.value);
+  return true;
+}
+
 bool base_actor::try_lock() {
   bool expect = _busy.load();
   if (expect) {
@@ -34,8 +34,12 @@ public:
   EXPORT virtual void on_child_status(const actor_address &addr, actor_status_kinds k);
   EXPORT virtual actor_action_when_error on_child_error(const actor_address &addr);
   EXPORT virtual void on_child_stopped(const actor_address &addr, const actor_stopping_reason reason);
-  EXPORT virtual void apply(mailbox &mbox);
+  EXPORT virtual void apply(abstract_mailbox &mbox);
   virtual void action_handle(const envelope &e) = 0;
+  /// called by apply for each drained batch. by default calls action_handle for
+  /// each envelope; if it throws, not handled envelopes are returned to the mailbox.
+  /// a custom handler passes envelopes to handle_ask_reply first.
+  EXPORT virtual void action_handle_batch(envelope_span batch);
 
   EXPORT bool try_lock();
 
@@ -47,10 +51,16 @@ public:
   EXPORT actor_address address();
   EXPORT void set_self_addr(const actor_address &sa);
 
+  const actor_settings &settings() const { return _settings; }
+  void set_settings(const actor_settings &s) { _settings = s; }
+
   std::shared_ptr<abstract_context> get_context() const { return _ctx.lock(); }
   void set_context(std::weak_ptr<abstract_context> ctx_) { _ctx = ctx_; }
 
 protected:
+  /// calls the callback of abstract_context::ask, if e is its reply.
+  EXPORT bool handle_ask_reply(const envelope &e);
+
   void update_status(actor_status_kinds kind) {
     _status.kind = kind;
     _status.msg.clear();
@@ -67,6 +77,10 @@ private:
 
   actor_address _sa;
   std::weak_ptr<abstract_context> _ctx;
+  actor_settings _settings = actor_settings::defsettings();
+
+  std::vector<envelope> _batch;
+  size_t _batch_handled = 0;
 };
 
 class actor_for_delegate final : public base_actor {
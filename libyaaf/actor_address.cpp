@@ -0,0 +1,159 @@
+#include <libyaaf/actor_address.h>
+#include <libyaaf/utils/exception.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+
+namespace {
+const uint32_t chunk_size = 4096;
+const uint32_t max_chunks = 4096;
+const size_t locks_count = 64;
+
+struct path_slot {
+  uint32_t generation = 0;
+  bool used = false;
+  std::string value;
+};
+
+struct alignas(64) slot_lock {
+  std::mutex locker;
+};
+
+struct alignas(64) intern_shard {
+  std::mutex locker;
+  std::unordered_map<std::string, path_handle> paths;
+};
+
+/// slots are allocated by chunks and are never moved, a freed slot is reused.
+struct path_registry {
+  std::array<std::atomic<path_slot *>, max_chunks> chunks;
+  std::mutex locker;
+  std::vector<uint32_t> free;
+  uint32_t slots = 0;
+  size_t used = 0;
+  /// a slot is guarded by a lock of its number.
+  std::array<slot_lock, locks_count> locks;
+  /// paths of addresses out of a context, they are never freed.
+  std::array<intern_shard, locks_count> interned;
+};
+
+std::mutex &lock_of(path_registry &r, uint32_t slot) {
+  return r.locks[slot % locks_count].locker;
+}
+
+path_slot *slot_of(path_registry &r, uint32_t slot) {
+  auto chunk = r.chunks[slot / chunk_size].load(std::memory_order_acquire);
+  return chunk == nullptr ? nullptr : &chunk[slot % chunk_size];
+}
+
+path_handle add_path(path_registry &r, const std::string &value) {
+  uint32_t index = 0;
+  {
+    std::lock_guard<std::mutex> lg(r.locker);
+    if (!r.free.empty()) {
+      index = r.free.back();
+      r.free.pop_back();
+    } else {
+      index = r.slots;
+      auto chunk = index / chunk_size;
+      if (chunk >= max_chunks) {
+        THROW_EXCEPTION("actor_address: too many paths");
+      }
+      if (index % chunk_size == 0) {
+        r.chunks[chunk].store(new path_slot[chunk_size], std::memory_order_release);
+      }
+      ++r.slots;
+    }
+    ++r.used;
+  }
+  auto s = slot_of(r, index);
+  std::lock_guard<std::mutex> lg(lock_of(r, index));
+  s->used = true;
+  s->value = value;
+  return path_handle{index, s->generation};
+}
+
+void free_path(path_registry &r, path_handle h) {
+  auto s = slot_of(r, h.slot);
+  {
+    std::lock_guard<std::mutex> lg(lock_of(r, h.slot));
+    if (!s->used || s->generation != h.generation) {
+      return;
+    }
+    s->used = false;
+    s->generation++;
+    std::string().swap(s->value);
+  }
+  std::lock_guard<std::mutex> lg(r.locker);
+  r.free.push_back(h.slot);
+  --r.used;
+}
+
+path_registry &registry() {
+  // never freed: addresses may be used by destructors of other statics.
+  static path_registry *result = []() {
+    auto r = new path_registry();
+    for (auto &c : r->chunks) {
+      c.store(nullptr);
+    }
+    add_path(*r, "");
+    add_path(*r, "null");
+    return r;
+  }();
+  return *result;
+}
+} // namespace
+
+path_owner::~path_owner() {
+  if (_handle.slot != path_handle::empty_slot) {
+    free_path(registry(), _handle);
+  }
+}
+
+void path_owner::reset(const std::string &path) {
+  auto &r = registry();
+  if (_handle.slot != path_handle::empty_slot) {
+    free_path(r, _handle);
+  }
+  _handle = add_path(r, path);
+}
+
+path_handle actor_address::intern(const std::string &pathname) {
+  auto &r = registry();
+  auto &s = r.interned[std::hash<std::string>()(pathname) % locks_count];
+  std::lock_guard<std::mutex> lg(s.locker);
+  auto it = s.paths.find(pathname);
+  if (it != s.paths.end()) {
+    return it->second;
+  }
+  auto result = add_path(r, pathname);
+  s.paths.emplace(pathname, result);
+  return result;
+}
+
+std::string actor_address::resolve(path_handle h) {
+  if (h.slot == path_handle::empty_slot) {
+    return std::string();
+  }
+  if (h.slot == path_handle::null_slot) {
+    return "null";
+  }
+  auto &r = registry();
+  auto s = slot_of(r, h.slot);
+  if (s == nullptr) {
+    return std::string();
+  }
+  std::lock_guard<std::mutex> lg(lock_of(r, h.slot));
+  return s->used && s->generation == h.generation ? s->value : std::string();
+}
+
+size_t actor_address::interned() {
+  auto &r = registry();
+  std::lock_guard<std::mutex> lg(r.locker);
+  return r.used;
+}
@@ -2,40 +2,85 @@
 
 #include <libyaaf/exports.h>
 #include <libyaaf/types.h>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 namespace yaaf {
+namespace inner {
+/// a path in the registry of paths of the process: a slot and its generation.
+/// a slot of a freed path gets the next generation, so an old handle is not
+/// resolved.
+struct path_handle {
+  /// slots of the empty and "null" paths, they are never freed.
+  static constexpr uint32_t empty_slot = 0;
+  static constexpr uint32_t null_slot = 1;
 
+  uint32_t slot;
+  uint32_t generation;
+
+  bool operator==(const path_handle &other) const {
+    return slot == other.slot && generation == other.generation;
+  }
+  bool operator!=(const path_handle &other) const { return !(*this == other); }
+};
+
+/// registers a path, which is freed with the owner. a description of an actor
+/// owns its path, so addresses of a gone actor do not resolve it.
+class path_owner final {
+public:
+  path_owner() : _handle{path_handle::empty_slot, 0} {}
+  path_owner(const path_owner &) = delete;
+  path_owner &operator=(const path_owner &) = delete;
+  EXPORT ~path_owner();
+
+  /// registers the path, the previous one is freed.
+  EXPORT void reset(const std::string &path);
+  path_handle handle() const { return _handle; }
+
+private:
+  path_handle _handle;
+};
+} // namespace inner
+
+/// id of an actor and a handle of its path: an address is two words, its copy
+/// and comparison do not touch the path. the path is resolved on demand.
 class actor_address {
 public:
-  actor_address() : _id(0) {}
-  actor_address(id_t id_) : _id(id_), _pathname("null") {}
-  actor_address(id_t id_, std::string pathname_) : _id(id_), _pathname(pathname_) {}
-  actor_address(const actor_address &other)
-      : _id(other._id), _pathname(other._pathname) {}
-
-  actor_address &operator=(const actor_address &other) {
-    if (this != &other) {
-      _id = other._id;
-      _pathname = other._pathname;
-    }
-    return *this;
-  }
-  ~actor_address() {}
+  actor_address() : _id(0), _path{inner::path_handle::empty_slot, 0} {}
+  actor_address(id_t id_) : _id(id_), _path{inner::path_handle::null_slot, 0} {}
+  actor_address(id_t id_, const inner::path_owner &path)
+      : _id(id_), _path(path.handle()) {}
+  /// the path is interned until the process exit, for addresses out of a context.
+  actor_address(id_t id_, const std::string &pathname_)
+      : _id(id_), _path(intern(pathname_)) {}
 
   bool empty() const { return _id == 0; }
   id_t get_id() const { return _id; }
-  std::string get_pathname() const { return _pathname; }
+  inner::path_handle get_path() const { return _path; }
+  /// an empty string, if the path is freed with its actor.
+  std::string get_pathname() const { return resolve(_path); }
 
   bool operator==(const actor_address &other) const {
-    return _id == other._id && _pathname == other._pathname;
+    return _id == other._id && _path == other._path;
   }
+  bool operator!=(const actor_address &other) const { return !(*this == other); }
+
+  /// count of registered paths in the process.
+  EXPORT static size_t interned();
+
+private:
+  EXPORT static inner::path_handle intern(const std::string &pathname);
+  EXPORT static std::string resolve(inner::path_handle h);
 
 private:
   id_t _id;
-  std::string _pathname;
+  inner::path_handle _path;
 };
+
+static_assert(std::is_trivially_copyable_v<actor_address>);
+static_assert(sizeof(actor_address) == 16);
 } // namespace yaaf
 
 namespace std {
@@ -43,8 +88,9 @@ template <> class hash<yaaf::actor_address> {
 public:
   size_t operator()(const yaaf::actor_address &s) const {
     size_t h_id = std::hash<yaaf::id_t>()(s.get_id());
-    size_t h_str = std::hash<std::string>()(s.get_pathname());
-    return h_id ^ (h_str << 1);
+    auto p = s.get_path();
+    size_t h_path = std::hash<uint64_t>()((uint64_t(p.slot) << 32) | p.generation);
+    return h_id ^ (h_path << 1);
   }
 };
 
@@ -0,0 +1,16 @@
+#include <libyaaf/actor_ref.h>
+#include <libyaaf/actor_registry.h>
+
+using namespace yaaf;
+
+bool actor_ref::alive() const {
+  return lock() != nullptr;
+}
+
+std::shared_ptr<inner::description> actor_ref::lock() const {
+  auto result = _description.lock();
+  if (result == nullptr || result->stopped.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <libyaaf/actor_address.h>
+#include <libyaaf/exports.h>
+#include <memory>
+
+namespace yaaf {
+namespace inner {
+struct description;
+}
+
+/// resolved address of an actor. a send by a ref does not look up the context registry.
+/// a ref does not own the actor: after stop of the actor sends are dropped.
+class actor_ref {
+public:
+  actor_ref() = default;
+  actor_ref(const actor_address &addr, std::weak_ptr<inner::description> d)
+      : _address(addr), _description(std::move(d)) {}
+
+  bool empty() const { return _address.empty(); }
+  const actor_address &address() const { return _address; }
+  /// false if the actor was stopped.
+  EXPORT bool alive() const;
+  /// nullptr if the actor was stopped.
+  EXPORT std::shared_ptr<inner::description> lock() const;
+
+private:
+  actor_address _address;
+  std::weak_ptr<inner::description> _description;
+};
+} // namespace yaaf
@@ -0,0 +1,85 @@
+#include <libyaaf/actor_registry.h>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+
+void actor_registry::insert(const description_ptr &d) {
+  {
+    auto &s = shard(d->address.get_id());
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    s.descriptions[d->address.get_id()] = d;
+  }
+  {
+    auto &s = shard(d->name);
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    s.descriptions[d->name] = d;
+  }
+}
+
+description_ptr actor_registry::erase(id_t id) {
+  description_ptr result = nullptr;
+  {
+    auto &s = shard(id);
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    auto it = s.descriptions.find(id);
+    if (it == s.descriptions.end()) {
+      return nullptr;
+    }
+    result = it->second;
+    s.descriptions.erase(it);
+  }
+  {
+    auto &s = shard(result->name);
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    auto it = s.descriptions.find(result->name);
+    // the name may be taken by a newer actor.
+    if (it != s.descriptions.end() && it->second == result) {
+      s.descriptions.erase(it);
+    }
+  }
+  return result;
+}
+
+description_ptr actor_registry::find(id_t id) const {
+  auto &s = shard(id);
+  std::shared_lock<std::shared_mutex> lg(s.locker);
+  auto it = s.descriptions.find(id);
+  return it != s.descriptions.end() ? it->second : nullptr;
+}
+
+description_ptr actor_registry::find(const std::string &name) const {
+  auto &s = shard(name);
+  std::shared_lock<std::shared_mutex> lg(s.locker);
+  auto it = s.descriptions.find(name);
+  return it != s.descriptions.end() ? it->second : nullptr;
+}
+
+void actor_registry::for_each(
+    const std::function<void(const description_ptr &)> &f) const {
+  for (auto &s : _ids) {
+    std::shared_lock<std::shared_mutex> lg(s.locker);
+    for (auto &kv : s.descriptions) {
+      f(kv.second);
+    }
+  }
+}
+
+void actor_registry::clear() {
+  for (auto &s : _ids) {
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    s.descriptions.clear();
+  }
+  for (auto &s : _names) {
+    std::lock_guard<std::shared_mutex> lg(s.locker);
+    s.descriptions.clear();
+  }
+}
+
+size_t actor_registry::size() const {
+  size_t result = 0;
+  for (auto &s : _ids) {
+    std::shared_lock<std::shared_mutex> lg(s.locker);
+    result += s.descriptions.size();
+  }
+  return result;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <libyaaf/abstract_context.h>
+#include <libyaaf/actor.h>
+#include <libyaaf/exports.h>
+#include <libyaaf/types.h>
+#include <libyaaf/utils/async/thread_manager.h>
+#include <libyaaf/utils/utils.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace yaaf {
+namespace inner {
+class router;
+
+struct description {
+  actor_ptr actor;
+  /// the path of the address, it is freed with the description.
+  path_owner path;
+  actor_address address;
+  actor_settings settings;
+  std::shared_ptr<abstract_mailbox> mbox;
+  std::shared_ptr<abstract_context> usrcont;
+  std::string name;
+  id_t parent;
+  std::unordered_set<id_t> children;
+  /// created once, posted to user threads on each scheduling of the actor.
+  utils::async::task_wrapper_ptr run_task;
+  /// user thread of the last apply, see actor_affinity::STICKY.
+  std::atomic_size_t worker{std::numeric_limits<size_t>::max()};
+  /// thread of an actor_affinity::DEDICATED actor.
+  std::shared_ptr<utils::async::threads_pool> dedicated;
+  /// set for a router: envelopes go to its routees, see context::make_router.
+  std::shared_ptr<router> routing;
+  /// patterns of subscriptions and names of owned exchanges, they are cleaned up
+  /// on stop. guarded by the exchange locker of the context.
+  std::vector<std::string> subscriptions;
+  std::vector<std::string> exchanges;
+  /// set on stop. actor_ref holders check it instead of the registry.
+  std::atomic_bool stopped{false};
+};
+
+using description_ptr = std::shared_ptr<description>;
+
+/// descriptions of all actors by id and by name.
+/// both indexes are split to shards with own locks, so a lookup waits only
+/// for an insert or an erase to the same shard.
+class actor_registry final : public utils::non_copy {
+public:
+  static const size_t shards_count = 64;
+
+  EXPORT void insert(const description_ptr &d);
+  /// returns the erased description or nullptr.
+  EXPORT description_ptr erase(id_t id);
+  EXPORT description_ptr find(id_t id) const;
+  EXPORT description_ptr find(const std::string &name) const;
+  bool contains(id_t id) const { return find(id) != nullptr; }
+
+  /// f is called under a lock of a shard, it must not change the registry.
+  EXPORT void for_each(const std::function<void(const description_ptr &)> &f) const;
+  EXPORT void clear();
+  EXPORT size_t size() const;
+
+private:
+  struct alignas(64) id_shard {
+    mutable std::shared_mutex locker;
+    std::unordered_map<id_t, description_ptr> descriptions;
+  };
+
+  struct alignas(64) name_shard {
+    mutable std::shared_mutex locker;
+    std::unordered_map<std::string, description_ptr> descriptions;
+  };
+
+  id_shard &shard(id_t id) { return _ids[id.value % shards_count]; }
+  const id_shard &shard(id_t id) const { return _ids[id.value % shards_count]; }
+  name_shard &shard(const std::string &name) {
+    return _names[std::hash<std::string>()(name) % shards_count];
+  }
+  const name_shard &shard(const std::string &name) const {
+    return _names[std::hash<std::string>()(name) % shards_count];
+  }
+
+private:
+  std::array<id_shard, shards_count> _ids;
+  std::array<name_shard, shards_count> _names;
+};
+} // namespace inner
+} // namespace yaaf
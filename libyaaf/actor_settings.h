@@ -1,12 +1,43 @@
 #pragma once
 
 #include <libyaaf/exports.h>
+#include <libyaaf/mailbox.h>
 
 namespace yaaf {
 
+/// NONE - any user thread runs the actor.
+/// STICKY - the actor runs on the user thread of its previous apply, an other
+/// thread steals it only while that one is busy. needs a WORK_STEALING user queue.
+/// DEDICATED - the actor has an own thread.
+enum class actor_affinity { NONE, STICKY, DEDICATED };
+
 class actor_settings {
 public:
   static EXPORT actor_settings defsettings();
+
+  mailbox_kinds mailbox_kind = mailbox_kinds::MPSC;
+  /// count of lanes of the mailbox, see envelope::priority.
+  /// 0 or 1 - one FIFO for all envelopes.
+  size_t priority_lanes = 0;
+  /// max count of envelopes taken from a mailbox by one drain.
+  size_t batch_size = 64;
+  /// max count of envelopes handled by one apply. 0 - without a limit.
+  /// after the limit the actor yields a thread and is scheduled again.
+  size_t throughput = 0;
+  /// max time of one apply in microseconds. 0 - without a limit.
+  size_t time_quota_us = 0;
+  /// max count of envelopes in the mailbox. 0 - without a limit.
+  size_t capacity = 0;
+  /// what to do with an envelope, which does not fit in the mailbox.
+  overflow_policy overflow = overflow_policy::DROP_NEWEST;
+  /// max wait of a sender for overflow_policy::BLOCK in microseconds.
+  size_t block_timeout_us = 100000;
+  /// receiver for overflow_policy::DEAD_LETTER. empty - /root/sys/dead_letters.
+  actor_address dead_letters;
+  /// where the actor runs. children do not inherit it.
+  actor_affinity affinity = actor_affinity::NONE;
+  /// cpu of the actor_affinity::DEDICATED thread. -1 - the thread is not pinned.
+  int cpu = -1;
 };
 
 }; // namespace yaaf
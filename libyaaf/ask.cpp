@@ -0,0 +1,249 @@
+#include <libyaaf/ask.h>
+#include <libyaaf/utils/logger.h>
+#include <algorithm>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+using namespace yaaf::utils::logging;
+
+namespace {
+const uint64_t index_bits = 24;
+const uint64_t index_mask = (uint64_t(1) << index_bits) - 1;
+} // namespace
+
+ask_ptr::ask_ptr(const ask_ptr &other) : _pool(other._pool), _state(other._state) {
+  if (_state != nullptr) {
+    _state->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ask_ptr::~ask_ptr() {
+  if (_state != nullptr) {
+    _pool->unref(_state);
+  }
+}
+
+ask_ptr &ask_ptr::operator=(const ask_ptr &other) {
+  if (this != &other) {
+    ask_ptr tmp(other);
+    *this = std::move(tmp);
+  }
+  return *this;
+}
+
+ask_ptr &ask_ptr::operator=(ask_ptr &&other) noexcept {
+  if (this != &other) {
+    if (_state != nullptr) {
+      _pool->unref(_state);
+    }
+    _pool = std::move(other._pool);
+    _state = other._state;
+    other._state = nullptr;
+  }
+  return *this;
+}
+
+ask_pool::ask_pool() : _slots(0), _pending(0) {
+  static_assert(chunk_size * max_chunks <= index_mask + 1, "ask_pool: too many slots");
+  for (auto &c : _chunks) {
+    c.store(nullptr);
+  }
+}
+
+ask_pool::~ask_pool() {
+  for (auto &c : _chunks) {
+    delete[] c.load();
+  }
+}
+
+ask_ptr ask_pool::acquire(std::chrono::milliseconds timeout, ask_callback cb,
+                          const actor_address &asker) {
+  ask_state *s = nullptr;
+  {
+    std::lock_guard<std::mutex> lg(_locker);
+    if (!_free.empty()) {
+      s = slot(_free.back());
+      _free.pop_back();
+    } else {
+      auto index = _slots;
+      auto chunk = index / chunk_size;
+      if (chunk >= max_chunks) {
+        THROW_EXCEPTION("ask_pool: too many pending requests");
+      }
+      if (index % chunk_size == 0) {
+        auto states = new ask_state[chunk_size];
+        for (size_t i = 0; i < chunk_size; ++i) {
+          states[i].index = static_cast<uint32_t>(index + i);
+        }
+        _chunks[chunk].store(states, std::memory_order_release);
+      }
+      ++_slots;
+      s = slot(index);
+    }
+  }
+
+  uint64_t id = 0;
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  {
+    std::lock_guard<std::mutex> lg(s->locker);
+    s->generation++;
+    id = (s->generation << index_bits) | s->index;
+    s->id = id;
+    s->deadline = deadline;
+    s->status = ask_status::PENDING;
+    s->callback = std::move(cb);
+    s->asker = asker;
+  }
+  // one reference is kept until the request is completed, one is returned.
+  s->refs.store(2, std::memory_order_relaxed);
+  _pending.fetch_add(1);
+
+  {
+    std::lock_guard<std::mutex> lg(_deadlines_locker);
+    _deadlines.push_back(deadline_t{deadline, id});
+    std::push_heap(_deadlines.begin(), _deadlines.end(), std::greater<deadline_t>());
+    compact_deadlines();
+  }
+  return ask_ptr(shared_from_this(), s);
+}
+
+ask_state *ask_pool::slot(uint64_t id) const {
+  auto index = id & index_mask;
+  auto chunk = _chunks[index / chunk_size].load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  return &chunk[index % chunk_size];
+}
+
+bool ask_pool::complete(uint64_t id, payload_t &&value) {
+  auto s = slot(id);
+  if (s == nullptr) {
+    return false;
+  }
+  return finish(s, id, ask_status::REPLIED, std::move(value));
+}
+
+bool ask_pool::finish(ask_state *s, uint64_t id, ask_status status, payload_t &&value) {
+  ask_callback cb;
+  actor_address asker;
+  {
+    std::lock_guard<std::mutex> lg(s->locker);
+    // id 0 is a free state.
+    if (id == 0 || s->id != id || s->status != ask_status::PENDING) {
+      return false;
+    }
+    s->status = status;
+    s->value = std::move(value);
+    cb = std::move(s->callback);
+    s->callback = nullptr;
+    asker = std::move(s->asker);
+  }
+  s->cond.notify_all();
+  if (cb != nullptr) {
+    try {
+      if (!asker.empty() && _delivery != nullptr) {
+        // the state is not read after the callback, the value goes to the asker.
+        _delivery(asker, id, ask_reply{status, std::move(s->value), std::move(cb)});
+      } else {
+        cb(status, s->value);
+      }
+    } catch (std::exception &ex) {
+      logger_warn("ask: callback error: ", ex.what());
+    }
+  }
+  _pending.fetch_sub(1);
+  unref(s);
+  return true;
+}
+
+size_t ask_pool::expire(std::chrono::steady_clock::time_point now) {
+  size_t result = 0;
+  for (;;) {
+    deadline_t d;
+    {
+      std::lock_guard<std::mutex> lg(_deadlines_locker);
+      if (_deadlines.empty() || _deadlines.front().deadline > now) {
+        break;
+      }
+      d = _deadlines.front();
+      std::pop_heap(_deadlines.begin(), _deadlines.end(), std::greater<deadline_t>());
+      _deadlines.pop_back();
+    }
+    if (finish(slot(d.id), d.id, ask_status::TIMEOUT, payload_t())) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+void ask_pool::expire_all() {
+  expire(std::chrono::steady_clock::time_point::max());
+}
+
+std::chrono::steady_clock::time_point ask_pool::next_deadline() {
+  std::lock_guard<std::mutex> lg(_deadlines_locker);
+  while (!_deadlines.empty() && !is_pending(_deadlines.front().id)) {
+    std::pop_heap(_deadlines.begin(), _deadlines.end(), std::greater<deadline_t>());
+    _deadlines.pop_back();
+  }
+  if (_deadlines.empty()) {
+    return std::chrono::steady_clock::time_point::max();
+  }
+  return _deadlines.front().deadline;
+}
+
+bool ask_pool::is_pending(uint64_t id) const {
+  auto s = slot(id);
+  if (s == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lg(s->locker);
+  return s->id == id && s->status == ask_status::PENDING;
+}
+
+void ask_pool::compact_deadlines() {
+  // amortized: the heap is rebuilt when it is twice bigger than pending requests.
+  if (_deadlines.size() <= 2 * _pending.load() + 64) {
+    return;
+  }
+  auto it = std::remove_if(_deadlines.begin(), _deadlines.end(),
+                           [this](const deadline_t &d) { return !is_pending(d.id); });
+  _deadlines.erase(it, _deadlines.end());
+  std::make_heap(_deadlines.begin(), _deadlines.end(), std::greater<deadline_t>());
+}
+
+ask_status ask_pool::wait(ask_state *s) {
+  uint64_t id = 0;
+  {
+    std::unique_lock<std::mutex> lk(s->locker);
+    s->cond.wait_until(lk, s->deadline,
+                       [s]() { return s->status != ask_status::PENDING; });
+    if (s->status != ask_status::PENDING) {
+      return s->status;
+    }
+    id = s->id;
+  }
+  // the deadline is passed, but the context did not expire the request yet.
+  finish(s, id, ask_status::TIMEOUT, payload_t());
+  std::lock_guard<std::mutex> lg(s->locker);
+  return s->status;
+}
+
+size_t ask_pool::capacity() const {
+  std::lock_guard<std::mutex> lg(_locker);
+  return _slots;
+}
+
+void ask_pool::unref(ask_state *s) {
+  if (s->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lg(s->locker);
+    s->id = 0;
+    s->value.reset();
+  }
+  std::lock_guard<std::mutex> lg(_locker);
+  _free.push_back(s->index);
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <libyaaf/actor_address.h>
+#include <libyaaf/exports.h>
+#include <libyaaf/payload.h>
+#include <libyaaf/utils/utils.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace yaaf {
+namespace inner {
+
+enum class ask_status { PENDING, REPLIED, TIMEOUT };
+using ask_callback = std::function<void(ask_status status, const payload_t &reply)>;
+
+/// a completed request of an actor. it goes to the mailbox of the asker with the
+/// correlation id of the request, so the callback is called on a turn of the asker.
+struct ask_reply {
+  ask_status status;
+  payload_t value;
+  ask_callback callback;
+};
+
+using ask_delivery =
+    std::function<void(const actor_address &asker, uint64_t id, ask_reply &&reply)>;
+
+struct ask_state {
+  std::atomic_size_t refs{0};
+  uint32_t index = 0;
+  uint64_t generation = 0;
+
+  std::mutex locker;
+  std::condition_variable cond;
+  uint64_t id = 0;
+  std::chrono::steady_clock::time_point deadline;
+  ask_status status = ask_status::PENDING;
+  payload_t value;
+  ask_callback callback;
+  /// not empty, if the callback is called by the asker, see ask_reply.
+  actor_address asker;
+};
+
+class ask_pool;
+
+/// counted reference to a pooled ask_state.
+class ask_ptr {
+public:
+  ask_ptr() : _state(nullptr) {}
+  /// takes one reference, which is already counted.
+  ask_ptr(std::shared_ptr<ask_pool> pool, ask_state *s)
+      : _pool(std::move(pool)), _state(s) {}
+  EXPORT ask_ptr(const ask_ptr &other);
+  ask_ptr(ask_ptr &&other) noexcept
+      : _pool(std::move(other._pool)), _state(other._state) {
+    other._state = nullptr;
+  }
+  EXPORT ~ask_ptr();
+
+  EXPORT ask_ptr &operator=(const ask_ptr &other);
+  EXPORT ask_ptr &operator=(ask_ptr &&other) noexcept;
+
+  ask_state *get() const { return _state; }
+  ask_state *operator->() const { return _state; }
+  ask_pool *pool() const { return _pool.get(); }
+  explicit operator bool() const { return _state != nullptr; }
+
+private:
+  std::shared_ptr<ask_pool> _pool;
+  ask_state *_state;
+};
+
+/// states of pending requests. states are reused: after a warm up a request
+/// does not allocate. a correlation id is a number of a state and its generation,
+/// so a reply finds its state without a lookup in a map.
+class ask_pool final : public utils::non_copy,
+                       public std::enable_shared_from_this<ask_pool> {
+public:
+  static const size_t chunk_size = 4096;
+  static const size_t max_chunks = 4096;
+
+  EXPORT ask_pool();
+  EXPORT ~ask_pool();
+
+  /// a new pending request. cb is called once: on a reply or on the timeout.
+  /// if the asker is not empty, cb is passed to it as ask_reply by the delivery.
+  EXPORT ask_ptr acquire(std::chrono::milliseconds timeout, ask_callback cb,
+                         const actor_address &asker = actor_address());
+  /// must be set before the first request with an asker.
+  void set_delivery(ask_delivery d) { _delivery = std::move(d); }
+  /// false if the request is already completed or expired.
+  EXPORT bool complete(uint64_t id, payload_t &&value);
+  /// completes requests with an expired deadline by ask_status::TIMEOUT.
+  EXPORT size_t expire(std::chrono::steady_clock::time_point now);
+  EXPORT void expire_all();
+  /// the nearest deadline of a pending request.
+  EXPORT std::chrono::steady_clock::time_point next_deadline();
+  /// waits for a reply or the deadline.
+  EXPORT ask_status wait(ask_state *s);
+
+  size_t pending() const { return _pending.load(); }
+  /// count of created states, pending and free.
+  EXPORT size_t capacity() const;
+
+  EXPORT void unref(ask_state *s);
+
+private:
+  ask_state *slot(uint64_t id) const;
+  bool finish(ask_state *s, uint64_t id, ask_status status, payload_t &&value);
+  bool is_pending(uint64_t id) const;
+  /// removes deadlines of completed requests, if they are most of the heap.
+  void compact_deadlines();
+
+private:
+  struct deadline_t {
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t id;
+    bool operator>(const deadline_t &other) const { return deadline > other.deadline; }
+  };
+
+  std::array<std::atomic<ask_state *>, max_chunks> _chunks;
+  mutable std::mutex _locker;
+  std::vector<uint32_t> _free;
+  size_t _slots;
+
+  mutable std::mutex _deadlines_locker;
+  /// min-heap by std::greater. a completed request leaves its deadline here,
+  /// such deadlines are skipped and removed lazily.
+  std::vector<deadline_t> _deadlines;
+
+  std::atomic_size_t _pending;
+  ask_delivery _delivery;
+};
+} // namespace inner
+
+/// result of abstract_context::ask.
+template <class REPLY> class ask_future {
+public:
+  ask_future() = default;
+  explicit ask_future(inner::ask_ptr state) : _state(std::move(state)) {}
+
+  bool valid() const { return static_cast<bool>(_state); }
+
+  /// waits for the reply or the timeout. true if the reply is received.
+  bool wait() const {
+    return _state.pool()->wait(_state.get()) == inner::ask_status::REPLIED;
+  }
+
+  /// waits for the reply. throws on the timeout or a reply of other type.
+  const REPLY &get() const {
+    if (!wait()) {
+      THROW_EXCEPTION("ask: timeout");
+    }
+    // a shared reply is immutable, so the value is read by the const accessor.
+    const payload_t &value = _state->value;
+    return value.template get<REPLY>();
+  }
+
+private:
+  inner::ask_ptr _state;
+};
+} // namespace yaaf
@@ -1,7 +1,7 @@
 #include <libyaaf/actor_address.h>
 #include <libyaaf/context.h>
 #include <libyaaf/utils/logger.h>
-#include <unordered_set>
+#include <algorithm>
 
 using namespace yaaf;
 using namespace yaaf::utils::logging;
@@ -16,8 +16,9 @@ const thread_kind_t NETWORK = 3;
 
 class user_context final : public abstract_context {
 public:
-  user_context(std::weak_ptr<context> ctx, const actor_address &addr, std::string name)
-      : _ctx(ctx), _addr(addr), _name(name) {
+  user_context(std::weak_ptr<context> ctx, std::shared_ptr<yaaf::inner::ask_pool> asks,
+               const actor_address &addr, std::string name)
+      : _ctx(ctx), _asks(asks), _addr(addr), _name(name) {
     ENSURE(_addr.get_pathname() != "null");
     ENSURE(_addr.get_pathname() != "");
     ENSURE(_name != "null");
@@ -37,22 +38,87 @@ public:
   void send_envelope(const actor_address &target, const envelope &e) override {
     if (auto c = _ctx.lock()) {
       if (!c->is_stopping_begin()) {
-        envelope cp{e.payload, _addr};
+        envelope cp = e;
+        cp.sender = _addr;
         c->send_envelope(target, std::move(cp));
       }
     }
     // THROW_EXCEPTION("context is nullptr");
   }
 
-  void send_envelope(const actor_address &target, const envelope &&e) override {
+  void send_envelope(const actor_address &target, envelope &&e) override {
     if (auto c = _ctx.lock()) {
       if (!c->is_stopping_begin()) {
-        envelope cp{e.payload, _addr};
+        e.sender = _addr;
+        c->send_envelope(target, std::move(e));
+      }
+    }
+  }
+
+  void send_envelope(const actor_ref &target, const envelope &e) override {
+    if (auto c = _ctx.lock()) {
+      if (!c->is_stopping_begin()) {
+        envelope cp = e;
+        cp.sender = _addr;
         c->send_envelope(target, std::move(cp));
       }
     }
   }
 
+  void send_envelope(const actor_ref &target, envelope &&e) override {
+    if (auto c = _ctx.lock()) {
+      if (!c->is_stopping_begin()) {
+        e.sender = _addr;
+        c->send_envelope(target, std::move(e));
+      }
+    }
+  }
+
+  yaaf::inner::ask_ptr ask_envelope(const actor_address &target, envelope &&e,
+                                    std::chrono::milliseconds timeout,
+                                    yaaf::inner::ask_callback cb) override {
+    if (auto c = _ctx.lock()) {
+      if (!c->is_stopping_begin()) {
+        e.sender = _addr;
+        return c->ask_envelope(target, std::move(e), timeout, std::move(cb));
+      }
+    }
+    THROW_EXCEPTION("context is stopped");
+  }
+
+  void reply_envelope(const envelope &request, envelope &&e) override {
+    if (request.correlation_id != 0) {
+      // the context is not locked: the asker may release it right after the reply.
+      _asks->complete(request.correlation_id, std::move(e.payload));
+      return;
+    }
+    if (auto c = _ctx.lock()) {
+      if (!c->is_stopping_begin()) {
+        e.sender = _addr;
+        c->reply_envelope(request, std::move(e));
+      }
+    }
+  }
+
+  timer_handle schedule_envelope(const actor_address &target, envelope &&e,
+                                 std::chrono::microseconds delay,
+                                 std::chrono::microseconds period) override {
+    if (auto c = _ctx.lock()) {
+      if (!c->is_stopping_begin()) {
+        e.sender = _addr;
+        return c->schedule_envelope(target, std::move(e), delay, period);
+      }
+    }
+    return timer_handle();
+  }
+
+  bool cancel_timer(timer_handle h) override {
+    if (auto c = _ctx.lock()) {
+      return c->cancel_timer(h);
+    }
+    return false;
+  }
+
   void stop_actor(const actor_address &addr) {
     if (auto c = _ctx.lock()) {
       if (!c->is_stopping_begin()) {
@@ -91,6 +157,14 @@ public:
     return result;
   }
 
+  actor_ref get_ref(const actor_address &addr) const override {
+    actor_ref result;
+    if (auto c = _ctx.lock()) {
+      result = c->get_ref(addr);
+    }
+    return result;
+  }
+
   std::string name() const override { return _name; }
 
   void create_exchange(const std::string &name) override {
@@ -105,16 +179,23 @@ public:
     }
   }
 
+  void unsubscribe_from_exchange(const std::string &name) override {
+    if (auto c = _ctx.lock()) {
+      c->unsubscribe_from_exchange(_addr, name);
+    }
+  }
+
   void publish_to_exchange(const std::string &exchange, const envelope &e) override {
     if (auto c = _ctx.lock()) {
-      envelope cp{e.payload, _addr};
+      envelope cp = e;
+      cp.sender = _addr;
       c->publish_to_exchange(exchange, std::move(cp));
     }
   }
-  void publish_to_exchange(const std::string &exchange, const envelope &&e) override {
+  void publish_to_exchange(const std::string &exchange, envelope &&e) override {
     if (auto c = _ctx.lock()) {
-      envelope cp{std::move(e.payload), _addr};
-      c->publish_to_exchange(exchange, std::move(cp));
+      e.sender = _addr;
+      c->publish_to_exchange(exchange, std::move(e));
     }
   }
 
@@ -128,6 +209,7 @@ public:
 
 private:
   std::weak_ptr<context> _ctx;
+  std::shared_ptr<yaaf::inner::ask_pool> _asks;
   actor_address _addr;
   std::string _name;
 };
@@ -142,16 +224,66 @@ public:
   void action_handle(const envelope &e) { UNUSED(e); }
 };
 
+/// receives envelopes diverted from full mailboxes by default.
+class dead_letters_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) {
+    if (e.payload.is<dead_letter>()) {
+      logger_info("context: dead letter to ", e.payload.get<dead_letter>().target);
+    }
+  }
+};
+
+/// envelopes to a router are routed by senders, its mailbox stays empty.
+class router_actor final : public base_actor {
+public:
+  void action_handle(const envelope &e) { UNUSED(e); }
+};
+
 class root_actor final : public base_actor {
 public:
   void action_handle(const envelope &e) { UNUSED(e); }
 };
+
+std::shared_ptr<abstract_mailbox> make_mailbox(const actor_settings &settings) {
+  auto kind = settings.mailbox_kind;
+  if (settings.capacity != 0 && settings.overflow == overflow_policy::DROP_OLDEST) {
+    // senders pop the oldest envelope.
+    kind = mailbox_kinds::LOCKED;
+  }
+  std::shared_ptr<abstract_mailbox> result;
+  if (settings.priority_lanes > 1) {
+    result = std::make_shared<priority_mailbox>(settings.priority_lanes, kind);
+  } else {
+    switch (kind) {
+    case mailbox_kinds::LOCKED:
+      result = std::make_shared<mailbox>();
+      break;
+    case mailbox_kinds::MPSC:
+      result = std::make_shared<mpsc_mailbox>();
+      break;
+    }
+  }
+  if (settings.capacity != 0) {
+    result = std::make_shared<bounded_mailbox>(
+        result, settings.capacity, settings.overflow,
+        std::chrono::microseconds(settings.block_timeout_us));
+  }
+  return result;
+}
 } // namespace
 
 context::params_t context::params_t::defparams() {
   context::params_t r{};
   r.user_threads = 1;
   r.sys_threads = 1;
+  r.scheduler = scheduler_kinds::READY_QUEUE;
+  r.user_queue = utils::async::queue_kinds::SHARED;
+  r.actor_throughput = 0;
+  r.actor_time_quota_us = 0;
+  r.timer_tick_us = 1000;
+  r.idle_spins = 100;
+  r.idle_park_us = 10000;
 #if YAAF_NETWORK_ENABLED
   r.network_threads = 1;
 #endif
@@ -169,11 +301,13 @@ std::shared_ptr<context> context::make_context(const params_t &params, std::stri
 }
 
 context::context(const context::params_t &p, std::string name)
-    : abstract_context(), _params(p) {
+    : abstract_context(), _params(p),
+      _idle(p.idle_spins, std::chrono::microseconds(p.idle_park_us)) {
 
+  threads_pool::params_t user_pool(_params.user_threads, USER, _params.user_queue);
+  user_pool.cpus = _params.user_cpus;
   std::vector<threads_pool::params_t> pools{
-      threads_pool::params_t(_params.user_threads, USER),
-      threads_pool::params_t(_params.sys_threads, SYSTEM)};
+      user_pool, threads_pool::params_t(_params.sys_threads, SYSTEM)};
 #ifdef YAAF_NETWORK_ENABLED
   pools.emplace_back(_params.network_threads, NETWORK);
 #endif
@@ -185,6 +319,9 @@ context::context(const context::params_t &p, std::string name)
     _name = name;
   }
   _thread_manager = std::make_unique<thread_manager>(tparams);
+  _asks = std::make_shared<inner::ask_pool>();
+  _timers = std::make_unique<inner::timing_wheel>(
+      std::chrono::microseconds(_params.timer_tick_us));
 }
 
 context ::~context() {
@@ -200,9 +337,21 @@ void context::start() {
   auto t = sys_post([this]() { this->mailbox_worker(); }, CONTINUATION_STRATEGY::REPEAT);
   t = nullptr;
 
+  // a reply may complete a request after the context is released.
+  std::weak_ptr<context> self = weak_from_this();
+  _asks->set_delivery(
+      [self](const actor_address &asker, uint64_t id, inner::ask_reply &&reply) {
+        if (auto c = self.lock()) {
+          envelope e{payload_t(std::move(reply)), actor_address(), id};
+          c->send_envelope(asker, std::move(e));
+        }
+      });
+
   _root = make_actor<root_actor>("root");
   _usr_root = this->add_actor("usr", _root, std::make_shared<usr_actor>());
   _sys_root = this->add_actor("sys", _root, std::make_shared<sys_actor>());
+  _dead_letters =
+      this->add_actor("dead_letters", _sys_root, std::make_shared<dead_letters_actor>());
 
   network_init();
 }
@@ -210,6 +359,9 @@ void context::start() {
 void context::stop() {
   logger_info("context: stoping....");
   _stopping_begin = true;
+  // nobody will answer: waiters get the timeout now.
+  _asks->expire_all();
+  _idle.stop();
 
 #ifdef YAAF_NETWORK_ENABLED
   logger_info("context: network stopping");
@@ -224,6 +376,7 @@ void context::stop() {
   }
 
   _stopping_begin = true;
+  _net_service.stop();
   for (auto &&t : _net_threads) {
     t.join();
   }
@@ -231,23 +384,33 @@ void context::stop() {
 
   _thread_manager->stop();
   _thread_manager = nullptr;
+  stop_retired_threads();
 
-  std::lock_guard<std::shared_mutex> lg(_locker);
+  std::lock_guard<std::mutex> lg(_hierarchy_locker);
 #ifdef YAAF_NETWORK_ENABLED
   _network_listeners.clear();
 #endif
 
   logger_info("context: threads pools stopped.");
 
-  for (auto kv : _actors) {
-    logger_info("context: ", kv.second->name, " stopped.");
-    kv.second->actor->on_stop();
-    kv.second->usrcont = nullptr;
+  std::vector<inner::description_ptr> descriptions;
+  descriptions.reserve(_actors.size());
+  _actors.for_each([&descriptions](const inner::description_ptr &d) {
+    descriptions.push_back(d);
+  });
+  for (auto &d : descriptions) {
+    if (d->dedicated != nullptr) {
+      d->dedicated->stop();
+    }
+  }
+  for (auto &d : descriptions) {
+    logger_info("context: ", d->name, " stopped.");
+    d->stopped.store(true, std::memory_order_release);
+    d->actor->on_stop();
+    d->usrcont = nullptr;
   }
   logger_info("context: clear buffer.");
   _actors.clear();
-  _mboxes.clear();
-  _id_by_name.clear();
   logger_info("context: stoped");
 }
 
@@ -283,6 +446,12 @@ actor_address context::add_actor(const std::string &actor_name, const actor_ptr
 
 actor_address context::add_actor(const std::string &actor_name,
                                  const actor_address &parent, const actor_ptr a) {
+  return add_actor(actor_name, parent, a, nullptr);
+}
+
+actor_address context::add_actor(const std::string &actor_name,
+                                 const actor_address &parent, const actor_ptr a,
+                                 std::shared_ptr<inner::router> routing) {
   auto new_id = id_t(_next_actor_id++);
 
   logger_info("context: add actor #", actor_name);
@@ -292,40 +461,76 @@ actor_address context::add_actor(const std::string &actor_name,
   auto ucname = name() + "/#usercontext#" + std::to_string(new_id.value);
 
   auto settings = actor_settings::defsettings();
+  settings.throughput = _params.actor_throughput;
+  settings.time_quota_us = _params.actor_time_quota_us;
   std::string parent_name = "";
 
   actor_address cur_parent = parent.empty() ? _usr_root : parent;
   std::shared_ptr<inner::description> parent_description = nullptr;
 
   if (!cur_parent.empty()) {
-    std::shared_lock<std::shared_mutex> lg(_locker);
-    parent_description = _actors[cur_parent.get_id()];
+    parent_description = _actors.find(cur_parent.get_id());
+    if (parent_description == nullptr) {
+      THROW_EXCEPTION("context: parent ", cur_parent, " not found");
+    }
     d->parent = cur_parent.get_id();
     settings = parent_description->settings;
+    settings.affinity = actor_affinity::NONE;
+    settings.cpu = -1;
     parent_name = parent_description->name;
   } else {
     parent_name = "";
   }
 
   d->name = parent_name + "/" + actor_name;
-  actor_address result{new_id, d->name};
-  d->usrcont = std::make_shared<user_context>(self, result, ucname);
+  d->path.reset(d->name);
+  actor_address result{new_id, d->path};
+  d->usrcont = std::make_shared<user_context>(self, _asks, result, ucname);
   a->set_context(d->usrcont);
   d->actor = a;
   d->address = result;
   d->settings = a->on_init(settings);
+  d->mbox = make_mailbox(d->settings);
+  d->routing = std::move(routing);
+  a->set_settings(d->settings);
+
+  // the task must not own the description.
+  std::weak_ptr<inner::description> weak_d = d;
+  task run = [this, weak_d](const thread_info &tinfo) {
+    TKIND_CHECK(tinfo.kind, USER);
+    auto target = weak_d.lock();
+    if (target != nullptr && target->stopped.load(std::memory_order_acquire)) {
+      // envelopes left in a mailbox of a stopped actor are not handled.
+      target->actor->reset_busy();
+    } else if (target != nullptr) {
+      if (target->settings.affinity == actor_affinity::STICKY) {
+        target->worker.store(tinfo.thread_number, std::memory_order_relaxed);
+      }
+      this->run_actor(target);
+    }
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+  d->run_task = wrap_detached_task(run);
+  if (d->settings.affinity == actor_affinity::DEDICATED) {
+    threads_pool::params_t dedicated(1, USER);
+    if (d->settings.cpu >= 0) {
+      dedicated.cpus.push_back(size_t(d->settings.cpu));
+    }
+    d->dedicated = std::make_shared<threads_pool>(dedicated);
+  }
 
   a->set_self_addr(result);
 
   {
-    std::lock_guard<std::shared_mutex> lg(_locker);
+    // a stop of the parent walks its children under the same lock.
+    std::lock_guard<std::mutex> lg(_hierarchy_locker);
     if (parent_description != nullptr) {
+      if (parent_description->stopped.load(std::memory_order_acquire)) {
+        THROW_EXCEPTION("context: parent ", cur_parent, " is stopped");
+      }
       parent_description->children.insert(new_id);
     }
-
-    _actors[new_id] = d;
-    _id_by_name[d->name] = new_id;
-    _mboxes[new_id] = std::make_shared<mailbox>();
+    _actors.insert(d);
   }
 
   user_post([this, a]() { a->on_start(); });
@@ -333,6 +538,90 @@ actor_address context::add_actor(const std::string &actor_name,
   return result;
 }
 
+actor_address context::add_router(const std::string &name,
+                                  const router_settings &settings,
+                                  std::function<actor_ptr()> factory) {
+  auto routing = std::make_shared<inner::router>(settings, std::move(factory));
+  auto result =
+      add_actor(name, actor_address{}, std::make_shared<router_actor>(), routing);
+  resize_router(result, settings.routees);
+  return result;
+}
+
+void context::resize_router(const actor_address &router, size_t routees) {
+  auto d = _actors.find(router.get_id());
+  if (d == nullptr || d->routing == nullptr) {
+    THROW_EXCEPTION("context: ", router, " is not a router");
+  }
+  auto &routing = *d->routing;
+  std::lock_guard<std::mutex> lg(routing.resize_locker());
+  logger_info("context: resize router ", router, " to ", routees);
+
+  auto current = routing.routees()->routees;
+  std::vector<inner::description_ptr> removed;
+  while (current.size() > routees) {
+    auto routee = _actors.find(current.back().address().get_id());
+    if (routee != nullptr) {
+      removed.push_back(routee);
+    }
+    current.pop_back();
+  }
+  auto make_routee = [&]() {
+    auto name = std::to_string(_next_routee.fetch_add(1));
+    return get_ref(add_actor(name, d->address, routing.make_routee()));
+  };
+  // a stopped routee is replaced in its place of the ring.
+  for (auto &r : current) {
+    if (!r.alive()) {
+      r = make_routee();
+    }
+  }
+  while (current.size() < routees) {
+    current.push_back(make_routee());
+  }
+  routing.set_routees(std::move(current));
+
+  // new envelopes already go to other routees.
+  for (auto &routee : removed) {
+    stop_actor(routee->address);
+    reroute_mailbox(d, routee);
+  }
+}
+
+void context::reroute_mailbox(const inner::description_ptr &router,
+                              const inner::description_ptr &routee) {
+  // the busy flag owns the mailbox, a running routee finishes its batch first.
+  // a stopped dedicated pool drops the queued run task with the flag set.
+  task reroute = [this, router, routee](const thread_info &tinfo) {
+    TKIND_CHECK(tinfo.kind, USER);
+    if (!routee->actor->try_lock()) {
+      if (routee->dedicated == nullptr || !routee->dedicated->is_stopped()) {
+        return CONTINUATION_STRATEGY::REPEAT;
+      }
+    }
+    std::vector<envelope> left;
+    while (routee->mbox->drain(left, std::numeric_limits<size_t>::max()) != 0) {
+    }
+    logger_info("context: reroute ", left.size(), " envelopes of ", routee->address);
+    for (auto &e : left) {
+      deliver(router, std::move(e));
+    }
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+  _thread_manager->post(USER, wrap_task(reroute));
+}
+
+std::vector<actor_address> context::get_routees(const actor_address &router) const {
+  std::vector<actor_address> result;
+  auto d = _actors.find(router.get_id());
+  if (d != nullptr && d->routing != nullptr) {
+    for (auto &r : d->routing->routees()->routees) {
+      result.push_back(r.address());
+    }
+  }
+  return result;
+}
+
 void context::create_exchange(const actor_address &owner, const std::string &name) {
   std::lock_guard<std::shared_mutex> lg(_exchange_locker);
   create_exchange_unsafe(owner, name);
@@ -347,43 +636,104 @@ void context::create_exchange_unsafe(const actor_address &owner,
   } else {
     inner::exchange_t e;
     e.owner = owner;
-    e.pub = std::make_shared<mailbox>();
 
     _exchanges[name] = e;
+    auto d = _actors.find(owner.get_id());
+    if (d != nullptr) {
+      d->exchanges.push_back(name);
+    }
+  }
+}
+
+void context::collect_exchange_unsafe(const std::string &name) {
+  auto it = _exchanges.find(name);
+  if (it == _exchanges.end() || _actors.contains(it->second.owner.get_id()) ||
+      _topics.count(name) != 0) {
+    return;
   }
+  logger_info("context: remove exchange #", name);
+  _exchanges.erase(it);
 }
 
 void context::subscribe_to_exchange(const actor_address &target,
                                     const std::string &name) {
-  std::unique_lock<std::shared_mutex> elg(_exchange_locker, std::defer_lock);
-  std::unique_lock<std::shared_mutex> lg(_locker, std::defer_lock);
-  std::lock(elg, lg);
+  std::lock_guard<std::shared_mutex> lg(_exchange_locker);
 
   logger_info("context: subscribe to exchange ", target, " <= ", name);
-  auto eit = _exchanges.find(name);
-  if (eit == _exchanges.end()) {
+  if (!inner::topic_trie::is_pattern(name) && _exchanges.find(name) == _exchanges.end()) {
     create_exchange_unsafe(target, name);
-    eit = _exchanges.find(name);
   }
 
-  auto ait = _actors.find(target.get_id());
-  if (ait != _actors.end()) {
-    eit->second.subscribes.push_back(target.get_id());
+  auto d = _actors.find(target.get_id());
+  // a stopped actor is unsubscribed by unsubscribe_stopped, which waits for the lock.
+  if (d != nullptr && !d->stopped.load(std::memory_order_acquire) &&
+      _topics.subscribe(name, actor_ref(d->address, d))) {
+    d->subscriptions.push_back(name);
+  }
+}
+
+void context::unsubscribe_from_exchange(const actor_address &target,
+                                        const std::string &name) {
+  std::lock_guard<std::shared_mutex> lg(_exchange_locker);
+  logger_info("context: unsubscribe from exchange ", target, " <= ", name);
+  if (!_topics.unsubscribe(name, target.get_id())) {
+    return;
+  }
+  auto d = _actors.find(target.get_id());
+  if (d != nullptr) {
+    auto it = std::find(d->subscriptions.begin(), d->subscriptions.end(), name);
+    if (it != d->subscriptions.end()) {
+      *it = std::move(d->subscriptions.back());
+      d->subscriptions.pop_back();
+    }
+  }
+  collect_exchange_unsafe(name);
+}
+
+void context::unsubscribe_stopped(const std::vector<inner::description_ptr> &stopped) {
+  if (stopped.empty()) {
+    return;
+  }
+  std::lock_guard<std::shared_mutex> lg(_exchange_locker);
+  for (auto &d : stopped) {
+    for (auto &pattern : d->subscriptions) {
+      _topics.unsubscribe(pattern, d->address.get_id());
+      collect_exchange_unsafe(pattern);
+    }
+    d->subscriptions.clear();
+    for (auto &name : d->exchanges) {
+      collect_exchange_unsafe(name);
+    }
+    d->exchanges.clear();
   }
 }
 
 void context::publish_to_exchange(const std::string &exchange, const envelope &e) {
-  publish_to_exchange(exchange, std::move(e));
+  envelope cp = e;
+  publish_to_exchange(exchange, std::move(cp));
 }
 
-void context::publish_to_exchange(const std::string &exchange, const envelope &&e) {
-  std::shared_lock<std::shared_mutex> lg(_exchange_locker);
+void context::publish_to_exchange(const std::string &exchange, envelope &&e) {
   logger_info("context: publish to '", exchange, "'");
-  auto eit = _exchanges.find(exchange);
-  if (eit != _exchanges.end()) {
-    eit->second.pub->push(e);
-  } else {
-    logger_info("context: exchange not found - ", exchange);
+  auto subscribers = _topics.match(exchange);
+  if (subscribers->empty()) {
+    logger_info("context: no subscribers of '", exchange, "'");
+    return;
+  }
+  // many subscribers get copies of one shared value, a single one gets the value.
+  auto last = subscribers->size() - 1;
+  if (last != 0) {
+    e.payload.share();
+  }
+  for (size_t i = 0; i < last; ++i) {
+    auto d = (*subscribers)[i].lock();
+    if (d != nullptr) {
+      deliver(d, envelope(e));
+    }
+  }
+  auto d = (*subscribers)[last].lock();
+  if (d != nullptr) {
+    deliver(d, std::move(e));
   }
 };
 
@@ -393,102 +743,272 @@ bool context::exchange_exists(const std::string &name) const {
 }
 
 actor_weak context::get_actor(const actor_address &addr) const {
-  std::shared_lock<std::shared_mutex> lg(_locker);
   logger_info("context: get actor #", addr);
-  auto it = _actors.find(addr.get_id());
+  auto d = _actors.find(addr.get_id());
   actor_weak result;
-  if (it != _actors.end()) { // actor may be stopped
-    result = it->second->actor;
+  if (d != nullptr) { // actor may be stopped
+    result = d->actor;
   }
   return result;
 }
 
 actor_weak context::get_actor(const std::string &name) const {
-  std::shared_lock<std::shared_mutex> lg(_locker);
   logger_info("context: get actor by name '", name, "'");
   actor_weak result;
-  auto id_it = _id_by_name.find(name);
-  if (id_it != _id_by_name.end()) { // actor may be stopped
-    auto it = _actors.find(id_it->second);
-    if (it != _actors.end()) {
-      result = it->second->actor;
-    }
+  auto d = _actors.find(name);
+  if (d != nullptr) { // actor may be stopped
+    result = d->actor;
   }
   return result;
 }
 
 actor_address context::get_address(const std::string &name) const {
-  std::shared_lock<std::shared_mutex> lg(_locker);
   logger_info("context: get actor address by name '", name, "'");
   actor_address result;
-  auto id_it = _id_by_name.find(name);
-  if (id_it != _id_by_name.end()) { // actor may be stopped
-    auto it = _actors.find(id_it->second);
-    if (it != _actors.end()) {
-      result = it->second->address;
-    }
+  auto d = _actors.find(name);
+  if (d != nullptr) { // actor may be stopped
+    result = d->address;
   }
   return result;
 }
 
+actor_ref context::get_ref(const actor_address &addr) const {
+  auto d = _actors.find(addr.get_id());
+  if (d == nullptr) {
+    return actor_ref();
+  }
+  return actor_ref(d->address, d);
+}
+
 void context::send_envelope(const actor_address &target, const envelope &e) {
-  std::shared_lock<std::shared_mutex> lg(_locker);
   ENSURE(target.get_pathname() != "null");
   ENSURE(e.sender.get_pathname() != "null");
   logger_info("context: send to: ", target);
-  auto it = _mboxes.find(target.get_id());
-  if (it != _mboxes.end()) { // actor may be stopped
-    it->second->push(e);
+  auto d = _actors.find(target.get_id());
+  if (d != nullptr) { // actor may be stopped
+    deliver(d, envelope(e));
   }
 }
 
-void context::send_envelope(const actor_address &target, const envelope &&e) {
-  std::shared_lock<std::shared_mutex> lg(_locker);
+void context::send_envelope(const actor_address &target, envelope &&e) {
   ENSURE(target.get_pathname() != "null");
   ENSURE(e.sender.get_pathname() != "null");
   logger_info("context: send to: ", target);
-  auto it = _mboxes.find(target.get_id());
-  if (it != _mboxes.end()) { // actor may be stopped
-    it->second->push(std::move(e));
+  auto d = _actors.find(target.get_id());
+  if (d != nullptr) { // actor may be stopped
+    deliver(d, std::move(e));
+  }
+}
+
+void context::send_envelope(const actor_ref &target, const envelope &e) {
+  ENSURE(e.sender.get_pathname() != "null");
+  logger_info("context: send to: ", target.address());
+  auto d = target.lock();
+  if (d != nullptr) { // actor may be stopped
+    deliver(d, envelope(e));
+  }
+}
+
+void context::send_envelope(const actor_ref &target, envelope &&e) {
+  ENSURE(e.sender.get_pathname() != "null");
+  logger_info("context: send to: ", target.address());
+  auto d = target.lock();
+  if (d != nullptr) { // actor may be stopped
+    deliver(d, std::move(e));
+  }
+}
+
+void context::deliver(const inner::description_ptr &d, envelope &&e) {
+  if (d->routing != nullptr) {
+    auto routee = d->routing->select(e);
+    if (routee != nullptr) {
+      deliver(routee, std::move(e));
+    } else {
+      send_envelope(_dead_letters,
+                    envelope{dead_letter{d->address, std::move(e)}, actor_address()});
+    }
+    return;
+  }
+  if (d->mbox->offer(e)) {
+    schedule_actor(d);
+    return;
+  }
+
+  switch (d->settings.overflow) {
+  case overflow_policy::REJECT:
+  case overflow_policy::BLOCK:
+    // the notice has no sender: a reject of it is not answered.
+    if (!e.sender.empty() && e.sender != d->address) {
+      send_envelope(e.sender, envelope{mailbox_overflow{d->address}, actor_address()});
+    }
+    break;
+  case overflow_policy::DEAD_LETTER: {
+    auto receiver =
+        d->settings.dead_letters.empty() ? _dead_letters : d->settings.dead_letters;
+    if (receiver != d->address) {
+      send_envelope(receiver,
+                    envelope{dead_letter{d->address, std::move(e)}, actor_address()});
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+mailbox_counters context::get_mailbox_counters(const actor_address &addr) const {
+  auto d = _actors.find(addr.get_id());
+  if (d == nullptr) {
+    return mailbox_counters();
+  }
+  return d->mbox->counters();
+}
+
+yaaf::inner::ask_ptr context::ask_envelope(const actor_address &target,
+                                           envelope &&e,
+                                           std::chrono::milliseconds timeout,
+                                           inner::ask_callback cb) {
+  // a callback of an actor is called on its turn, see inner::ask_reply.
+  auto asker = cb != nullptr ? e.sender : actor_address();
+  auto result = _asks->acquire(timeout, std::move(cb), asker);
+  e.correlation_id = result->id;
+  // the system thread may sleep until a later deadline.
+  _idle.notify();
+  // a request to a stopped actor is completed by the timeout.
+  send_envelope(target, std::move(e));
+  return result;
+}
+
+void context::reply_envelope(const envelope &request, envelope &&e) {
+  if (request.correlation_id != 0) {
+    _asks->complete(request.correlation_id, std::move(e.payload));
+  } else {
+    send_envelope(request.sender, std::move(e));
   }
 }
 
+timer_handle context::schedule_envelope(const actor_address &target, envelope &&e,
+                                        std::chrono::microseconds delay,
+                                        std::chrono::microseconds period) {
+  auto ref = get_ref(target);
+  if (ref.empty()) {
+    return timer_handle();
+  }
+  auto result = _timers->schedule(ref, std::move(e),
+                                  inner::timing_wheel::clock::now() + delay, period);
+  _idle.notify();
+  return result;
+}
+
+bool context::cancel_timer(timer_handle h) {
+  return _timers->cancel(h);
+}
+
+void context::schedule_actor(
+    const std::shared_ptr<inner::description> &target_actor_description) {
+  if (_stopping_begin) {
+    return;
+  }
+  if (_params.scheduler == scheduler_kinds::MAILBOX_SCAN) {
+    // the system thread posts the actor.
+    _idle.notify();
+    return;
+  }
+  // busy flag is a 'runnable' mark: only the first sender to an idle actor posts it.
+  if (!target_actor_description->actor->try_lock()) {
+    return;
+  }
+  if (target_actor_description->mbox->empty()) {
+    target_actor_description->actor->reset_busy();
+    return;
+  }
+
+  post_actor(target_actor_description);
+}
+
+void context::post_actor(const inner::description_ptr &d) {
+  logger_info("context: push to run queue #", d->address);
+  if (d->dedicated != nullptr) {
+    d->dedicated->post(d->run_task);
+    return;
+  }
+  auto worker = d->worker.load(std::memory_order_relaxed);
+  if (worker != std::numeric_limits<size_t>::max()) {
+    _thread_manager->post(USER, d->run_task, worker);
+  } else {
+    _thread_manager->post(USER, d->run_task);
+  }
+}
+
+void context::stop_retired_threads() {
+  std::vector<std::shared_ptr<threads_pool>> retired;
+  {
+    std::lock_guard<std::mutex> lg(_hierarchy_locker);
+    retired.swap(_retired_threads);
+  }
+  for (auto &t : retired) {
+    t->stop();
+  }
+}
+
+void context::run_actor(
+    const std::shared_ptr<inner::description> &target_actor_description) {
+  actor_ptr parent = nullptr;
+  if (!target_actor_description->parent.empty()) {
+    auto parent_description = _actors.find(target_actor_description->parent);
+    if (parent_description != nullptr) {
+      parent = parent_description->actor;
+    }
+  }
+  apply_actor_to_mailbox(target_actor_description, parent,
+                         target_actor_description->mbox);
+}
+
 void context::stop_actor(const actor_address &addr) {
   return stop_actor_impl_safety(addr.get_id(), actor_stopping_reason::MANUAL);
 }
 
 void context::stop_actor_impl_safety(const actor_address &addr,
                                      actor_stopping_reason reason) {
-  std::lock_guard<std::shared_mutex> lg(_locker);
-  return stop_actor_impl(addr.get_id(), reason);
+  std::vector<inner::description_ptr> stopped;
+  {
+    std::lock_guard<std::mutex> lg(_hierarchy_locker);
+    stop_actor_impl(addr.get_id(), reason, stopped);
+  }
+  // the exchange locker is not taken under the hierarchy locker.
+  unsubscribe_stopped(stopped);
 }
 
-void context::stop_actor_impl(const actor_address &addr, actor_stopping_reason reason) {
+void context::stop_actor_impl(const actor_address &addr, actor_stopping_reason reason,
+                              std::vector<inner::description_ptr> &stopped) {
   auto id = addr.get_id();
   logger_info("context: stop #", id);
-  auto it = _actors.find(id);
-  if (it != _actors.end()) { // double-stop protection;
-    auto desc = it->second;
-
+  auto desc = _actors.find(id);
+  if (desc != nullptr) { // double-stop protection;
+    desc->stopped.store(true, std::memory_order_release);
     for (auto &&c : desc->children) {
-      stop_actor_impl(c, reason);
+      stop_actor_impl(c, reason, stopped);
     }
 
     desc->actor->on_stop();
+    if (desc->dedicated != nullptr) {
+      _retired_threads.push_back(desc->dedicated);
+      _idle.notify();
+    }
     if (!desc->parent.empty()) {
       auto parent = _actors.find(desc->parent);
-      if (parent != _actors.end()) {
-        parent->second->actor->on_child_stopped(addr, reason);
+      if (parent != nullptr) {
+        parent->actor->on_child_stopped(addr, reason);
       }
     }
-    _mboxes.erase(id);
-    _actors.erase(it);
+    _actors.erase(id);
+    stopped.push_back(desc);
   }
 }
 
 void context::apply_actor_to_mailbox(
     const std::shared_ptr<inner::description> target_actor_description, actor_ptr parent,
-    std::shared_ptr<mailbox> mb) {
+    std::shared_ptr<abstract_mailbox> mb) {
   logger_info("context: apply ", target_actor_description->name);
   try {
     target_actor_description->actor->apply(*mb);
@@ -502,12 +1022,14 @@ void context::apply_actor_to_mailbox(
     if (parent != nullptr) {
       auto action = parent->on_child_error(target_actor_description->address);
       if (action == actor_action_when_error::ESCALATE) {
-        std::shared_lock<std::shared_mutex> lg(_locker);
         auto descr = target_actor_description;
         while (action == actor_action_when_error::ESCALATE) {
-          auto parent_it = _actors.find(descr->parent);
-          action = parent_it->second->actor->on_child_error(descr->address);
-          descr = parent_it->second;
+          auto parent_description = _actors.find(descr->parent);
+          if (parent_description == nullptr) {
+            break;
+          }
+          action = parent_description->actor->on_child_error(descr->address);
+          descr = parent_description;
         }
       }
       on_actor_error(action, target_actor_description, parent);
@@ -516,6 +1038,14 @@ void context::apply_actor_to_mailbox(
                                    actor_stopping_reason::EXCEPT);
     }
   }
+
+  // a sender could see the actor as busy while apply was finishing.
+  if (!mb->empty()) {
+    auto d = _actors.find(target_actor_description->address.get_id());
+    if (d != nullptr) {
+      schedule_actor(d);
+    }
+  }
 }
 
 void context::on_actor_error(
@@ -546,92 +1076,60 @@ void context::on_actor_error(
 }
 
 void context::mailbox_worker() {
-  if (_exchange_locker.try_lock_shared()) {
-    if (_locker.try_lock()) {
-      for (auto kv : _exchanges) {
-        yaaf::envelope e;
-        while (kv.second.pub->try_pop(e)) {
-          for (auto id : kv.second.subscribes) {
-            auto mb = _mboxes.find(id);
-            if (mb != _mboxes.end()) {
-              yaaf::envelope cp;
-              cp.payload = e.payload;
-              cp.sender = e.sender;
-              mb->second->push(e);
-            }
-          }
-        }
-      }
-      _locker.unlock();
+  auto now = std::chrono::steady_clock::now();
+  size_t done = _asks->expire(now);
+  done += _timers->advance(now, [this](const actor_ref &target, envelope &&e) {
+    if (!target.alive()) {
+      return false;
     }
-    _exchange_locker.unlock_shared();
-  }
-
-  if (!_locker.try_lock_shared()) {
-    return;
-  }
-  std::unordered_set<id_t> to_remove;
-
-  for (auto kv : _mboxes) {
-    auto mb = kv.second;
-    if (!mb->empty()) {
-
-      auto it = _actors.find(kv.first);
-      if (it == _actors.end()) {
-        to_remove.insert(kv.first);
-        continue;
+    send_envelope(target, std::move(e));
+    return true;
+  });
+
+  if (_params.scheduler == scheduler_kinds::MAILBOX_SCAN) {
+    _actors.for_each([this, &done](const inner::description_ptr
+                                       &target_actor_description) {
+      auto mb = target_actor_description->mbox;
+      if (mb->empty() || !target_actor_description->actor->try_lock()) {
+        return;
       }
 
-      auto target_actor_description = it->second;
-
-      if (target_actor_description->actor->try_lock()) {
-        if (mb->empty()) {
-          target_actor_description->actor->reset_busy();
-        } else {
-          actor_ptr parent = nullptr;
-
-          if (!target_actor_description->parent.empty()) {
-            parent = _actors[target_actor_description->parent]->actor;
-          }
-          logger_info("context: push to run queue #", target_actor_description->address);
-          user_post([this, target_actor_description, parent, mb]() {
-            this->apply_actor_to_mailbox(target_actor_description, parent, mb);
-          });
-        }
+      if (mb->empty()) {
+        target_actor_description->actor->reset_busy();
+      } else {
+        post_actor(target_actor_description);
+        ++done;
       }
-    }
+    });
   }
-  if (_exchange_locker.try_lock()) {
-    std::list<std::string> ex_to_remove;
-    for (auto &kv : _exchanges) {
-      auto owner_exists = _actors.find(kv.second.owner.get_id()) != _actors.end();
-      auto subsribers = std::any_of(
-          kv.second.subscribes.begin(), kv.second.subscribes.end(),
-          [this](const id_t id) { return _actors.find(id) != _actors.end(); });
-
-      if (!owner_exists && !subsribers) {
-        ex_to_remove.push_back(kv.first);
-      }
-    }
-
-    for (auto &n : ex_to_remove) {
-      _exchanges.erase(n);
+  if (_hierarchy_locker.try_lock()) {
+    auto has_retired = !_retired_threads.empty();
+    _hierarchy_locker.unlock();
+    if (has_retired) {
+      stop_retired_threads();
+      ++done;
     }
+  }
 
-    _exchange_locker.unlock();
+  if (done != 0) {
+    _idle.work();
+  } else {
+    auto deadline = std::min(_timers->next_deadline(), _asks->next_deadline());
+    _idle.idle(deadline, [this]() { return system_work_pending(); });
   }
-  _locker.unlock_shared();
+}
 
-  if (!to_remove.empty()) {
-    if (_locker.try_lock()) {
-      for (auto v : to_remove) {
-        _mboxes.erase(v);
+bool context::system_work_pending() {
+  bool result = false;
+  if (_params.scheduler == scheduler_kinds::MAILBOX_SCAN) {
+    // a busy actor is rescheduled at the end of its apply.
+    _actors.for_each([&result](const inner::description_ptr &d) {
+      if (!d->mbox->empty() && !d->actor->busy()) {
+        result = true;
       }
-      _locker.unlock();
-    }
+    });
   }
-
-  // TODO need a sleeping?
+  return result;
 }
 
 #ifndef YAAF_NETWORK_ENABLED
@@ -2,14 +2,18 @@
 
 #include <libyaaf/abstract_context.h>
 #include <libyaaf/actor.h>
+#include <libyaaf/actor_registry.h>
 #include <libyaaf/context_network.h>
 #include <libyaaf/exports.h>
+#include <libyaaf/router.h>
+#include <libyaaf/topic_trie.h>
 #include <libyaaf/types.h>
+#include <libyaaf/utils/async/idle_strategy.h>
 #include <libyaaf/utils/async/thread_manager.h>
 
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
-#include <unordered_set>
 #if YAAF_NETWORK_ENABLED
 #include <libdialler/listener.h>
 #include <libdialler/dialler.h>
@@ -17,27 +21,19 @@
 namespace yaaf {
 namespace inner {
 
-struct description {
-  actor_ptr actor;
-  actor_address address;
-  actor_settings settings;
-  std::shared_ptr<abstract_context> usrcont;
-  std::string name;
-  id_t parent;
-  std::unordered_set<id_t> children;
-};
-
 struct exchange_t {
-  std::vector<id_t> subscribes;
   actor_address owner;
-
-  std::shared_ptr<mailbox> pub;
 };
 } // namespace inner
 
 using yaaf::utils::async::CONTINUATION_STRATEGY;
 using yaaf::utils::async::task_result_ptr;
 
+/// MAILBOX_SCAN - the system thread walks all mailboxes and posts non-empty ones.
+/// READY_QUEUE - a sender posts the target actor to user threads on its first
+/// message, so the scheduling cost does not depend on the count of idle actors.
+enum class scheduler_kinds { MAILBOX_SCAN, READY_QUEUE };
+
 class context final : public abstract_context,
                       public std::enable_shared_from_this<context> {
 public:
@@ -50,6 +46,19 @@ public:
     EXPORT static params_t defparams();
     size_t user_threads;
     size_t sys_threads;
+    scheduler_kinds scheduler;
+    utils::async::queue_kinds user_queue;
+    /// cpus of user threads, see threads_pool::params_t::cpus.
+    std::vector<size_t> user_cpus;
+    /// defaults of actor_settings::throughput and time_quota_us for all actors.
+    size_t actor_throughput;
+    size_t actor_time_quota_us;
+    /// resolution of timers, see schedule_once.
+    size_t timer_tick_us;
+    /// the system thread without work yields idle_spins times, then sleeps
+    /// at most idle_park_us or until a send wakes it up. 0 - never sleeps.
+    size_t idle_spins;
+    size_t idle_park_us;
 
 #if YAAF_NETWORK_ENABLED
     size_t network_threads;
@@ -66,26 +75,58 @@ public:
   EXPORT void stop();
 
   EXPORT void send_envelope(const actor_address &target, const envelope &e) override;
-  EXPORT void send_envelope(const actor_address &target, const envelope &&e) override;
+  EXPORT void send_envelope(const actor_address &target, envelope &&e) override;
+  EXPORT void send_envelope(const actor_ref &target, const envelope &e) override;
+  EXPORT void send_envelope(const actor_ref &target, envelope &&e) override;
   EXPORT actor_address add_actor(const std::string &actor_name,
                                  const actor_ptr a) override;
   EXPORT actor_address add_actor(const std::string &actor_name,
                                  const actor_address &parent, const actor_ptr a);
+
+  /// a router with settings.routees children of ACTOR_T, created from copies of 'a'.
+  /// a send to the router goes to a mailbox of a routee.
+  template <class ACTOR_T, class... ARGS>
+  actor_address make_router(const std::string &name, const router_settings &settings,
+                            ARGS &&... a) {
+    auto factory = [a...]() -> actor_ptr { return std::make_shared<ACTOR_T>(a...); };
+    return add_router(name, settings, factory);
+  }
+  EXPORT actor_address add_router(const std::string &name,
+                                  const router_settings &settings,
+                                  std::function<actor_ptr()> factory);
+  /// removed routees are stopped, envelopes in their mailboxes go back to the router.
+  EXPORT void resize_router(const actor_address &router, size_t routees);
+  EXPORT std::vector<actor_address> get_routees(const actor_address &router) const;
+  EXPORT inner::ask_ptr ask_envelope(const actor_address &target, envelope &&e,
+                                     std::chrono::milliseconds timeout,
+                                     inner::ask_callback cb) override;
+  EXPORT void reply_envelope(const envelope &request, envelope &&e) override;
+  EXPORT timer_handle schedule_envelope(const actor_address &target, envelope &&e,
+                                        std::chrono::microseconds delay,
+                                        std::chrono::microseconds period) override;
+  EXPORT bool cancel_timer(timer_handle h) override;
   EXPORT void stop_actor(const actor_address &addr) override;
   EXPORT actor_weak get_actor(const actor_address &addr) const override;
   EXPORT actor_weak get_actor(const std::string &name) const override;
   EXPORT actor_address get_address(const std::string &name) const override;
+  EXPORT actor_ref get_ref(const actor_address &addr) const override;
+  /// counters of overflows of a bounded mailbox, see actor_settings::capacity.
+  EXPORT mailbox_counters get_mailbox_counters(const actor_address &addr) const;
 
   EXPORT std::string name() const override;
 
   bool is_stopping_begin() const { return _stopping_begin; }
 
   EXPORT void create_exchange(const actor_address &owner, const std::string &name);
+  /// name may be a pattern with '*' and '#', see inner::topic_trie.
   EXPORT void subscribe_to_exchange(const actor_address &target, const std::string &name);
+  /// an exchange without an owner and subscribers is removed.
+  EXPORT void unsubscribe_from_exchange(const actor_address &target,
+                                        const std::string &name);
   EXPORT void publish_to_exchange(const std::string &exchange,
                                   const envelope &e) override;
   EXPORT void publish_to_exchange(const std::string &exchange,
-                                  const envelope &&e) override;
+                                  envelope &&e) override;
   EXPORT bool exchange_exists(const std::string &name) const;
 #if YAAF_NETWORK_ENABLED
   void add_listener_on(dialler::listener::params_t &p);
@@ -96,11 +137,27 @@ public:
 private:
   void create_exchange(const std::string &) override {}
   void subscribe_to_exchange(const std::string &) override{};
+  void unsubscribe_from_exchange(const std::string &) override{};
   void mailbox_worker();
+  bool system_work_pending();
+  void schedule_actor(const std::shared_ptr<inner::description> &target_actor_description);
+  /// posts the run task to a thread of the actor affinity.
+  void post_actor(const inner::description_ptr &d);
+  void stop_retired_threads();
+  /// pushes to the mailbox and applies its overflow policy.
+  void deliver(const inner::description_ptr &d, envelope &&e);
+  /// sends envelopes of a removed routee back through its router.
+  void reroute_mailbox(const inner::description_ptr &router,
+                       const inner::description_ptr &routee);
+  void run_actor(const std::shared_ptr<inner::description> &target_actor_description);
   void stop_actor_impl_safety(const actor_address &addr, actor_stopping_reason reason);
-  void stop_actor_impl(const actor_address &addr, actor_stopping_reason reason);
+  void stop_actor_impl(const actor_address &addr, actor_stopping_reason reason,
+                       std::vector<inner::description_ptr> &stopped);
 
   void create_exchange_unsafe(const actor_address &owner, const std::string &name);
+  /// removes the exchange, if it has no owner and subscribers.
+  void collect_exchange_unsafe(const std::string &name);
+  void unsubscribe_stopped(const std::vector<inner::description_ptr> &stopped);
 
   task_result_ptr
   user_post(const std::function<void()> &f,
@@ -112,7 +169,7 @@ private:
 
   void apply_actor_to_mailbox(
       const std::shared_ptr<inner::description> target_actor_description,
-      actor_ptr parent, std::shared_ptr<mailbox> mb);
+      actor_ptr parent, std::shared_ptr<abstract_mailbox> mb);
 
   void on_actor_error(actor_action_when_error action,
                       const std::shared_ptr<inner::description> target_actor_description,
@@ -120,20 +177,32 @@ private:
 
   void network_init();
 
+  actor_address add_actor(const std::string &actor_name, const actor_address &parent,
+                          const actor_ptr a, std::shared_ptr<inner::router> routing);
+
 private:
   params_t _params;
+  utils::async::idle_strategy _idle;
   std::string _name;
   std::unique_ptr<utils::async::thread_manager> _thread_manager;
 
-  mutable std::shared_mutex _locker;
+  /// guards parent-children links. lookups and sends do not take it.
+  std::mutex _hierarchy_locker;
+  /// threads of stopped dedicated actors. the system thread joins them, because
+  /// an actor may be stopped from its own thread. guarded by _hierarchy_locker.
+  std::vector<std::shared_ptr<utils::async::threads_pool>> _retired_threads;
   std::atomic_uint64_t _next_actor_id{1};
+  std::atomic_uint64_t _next_routee{0};
 
-  std::unordered_map<id_t, std::shared_ptr<inner::description>> _actors;
-  std::unordered_map<std::string, id_t> _id_by_name;
-  std::unordered_map<id_t, std::shared_ptr<mailbox>> _mboxes;
+  inner::actor_registry _actors;
+  std::shared_ptr<inner::ask_pool> _asks;
+  std::unique_ptr<inner::timing_wheel> _timers;
 
   mutable std::shared_mutex _exchange_locker;
   std::unordered_map<std::string, inner::exchange_t> _exchanges;
+  /// subscriptions to exchanges. a publisher sends to a snapshot of subscribers
+  /// without _exchange_locker.
+  inner::topic_trie _topics;
 
   static std::atomic_size_t _ctx_id;
   bool _stopping_begin = false;
@@ -141,6 +210,7 @@ private:
   actor_address _root;
   actor_address _usr_root;
   actor_address _sys_root;
+  actor_address _dead_letters;
 
 #if YAAF_NETWORK_ENABLED
   actor_address _net_root;
@@ -157,8 +157,27 @@ void context::network_init() {
 
   for (int i = 0; i < _params.network_threads; ++i) {
     _net_threads.emplace_back([this]() {
+      const auto park = std::chrono::microseconds(_params.idle_park_us);
+      size_t spin = 0;
       while (!this->is_stopping_begin()) {
-        this->_net_service.poll_one();
+        if (this->_net_service.poll_one() != 0) {
+          spin = 0;
+          continue;
+        }
+        if (park.count() == 0) {
+          continue;
+        }
+        if (spin < _params.idle_spins) {
+          ++spin;
+          std::this_thread::yield();
+          continue;
+        }
+        spin = 0;
+        // sleeps in the reactor until a network event, stop() interrupts it.
+        if (this->_net_service.run_one() == 0 && !this->is_stopping_begin()) {
+          // nothing to wait: the service has no work.
+          std::this_thread::sleep_for(park);
+        }
       }
     });
   }
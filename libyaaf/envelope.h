@@ -4,11 +4,44 @@
 #include <libyaaf/exports.h>
 #include <libyaaf/payload.h>
 #include <libyaaf/types.h>
+#include <limits>
+#include <vector>
 
 namespace yaaf {
 
+/// priority of control messages: the top lane of a priority mailbox.
+/// a bounded mailbox accepts them over the capacity.
+const uint8_t system_priority = std::numeric_limits<uint8_t>::max();
+
 struct envelope {
   payload_t payload;
   actor_address sender;
+  /// not 0 for a request of abstract_context::ask.
+  uint64_t correlation_id = 0;
+  /// lane of a priority mailbox, bigger first. see actor_settings::priority_lanes.
+  uint8_t priority = 0;
+};
+
+/// non-owning view of continuous envelopes.
+class envelope_span {
+public:
+  envelope_span() : _first(nullptr), _count(0) {}
+  envelope_span(envelope *first, size_t count) : _first(first), _count(count) {}
+  envelope_span(std::vector<envelope> &v) : _first(v.data()), _count(v.size()) {}
+
+  envelope *begin() const { return _first; }
+  envelope *end() const { return _first + _count; }
+  size_t size() const { return _count; }
+  bool empty() const { return _count == 0; }
+  envelope &operator[](size_t i) const { return _first[i]; }
+
+  envelope_span subspan(size_t offset) const {
+    return offset < _count ? envelope_span(_first + offset, _count - offset)
+                           : envelope_span();
+  }
+
+private:
+  envelope *_first;
+  size_t _count;
 };
-} // namespace yaaf
\ No newline at end of file
+} // namespace yaaf
@@ -1,3 +1,286 @@
 #include <libyaaf/mailbox.h>
 
 using namespace yaaf;
+
+mpsc_mailbox::mpsc_mailbox() : _size(0) {
+  auto stub = new node;
+  _head.store(stub);
+  _tail = stub;
+}
+
+mpsc_mailbox::~mpsc_mailbox() {
+  auto n = _tail;
+  while (n != nullptr) {
+    auto next = n->next.load();
+    delete n;
+    n = next;
+  }
+}
+
+void mpsc_mailbox::push(const envelope &e) {
+  push_node(new node(e));
+}
+
+void mpsc_mailbox::push(envelope &&e) {
+  // the envelope is constructed in the node, the payload is not copied.
+  push_node(new node(std::move(e)));
+}
+
+void mpsc_mailbox::push_node(node *n) {
+  // size is increased before linking, so empty() is false when push returns
+  // and a consumer never decreases it below zero.
+  _size.fetch_add(1);
+  auto prev = _head.exchange(n, std::memory_order_acq_rel);
+  prev->next.store(n, std::memory_order_release);
+}
+
+bool mpsc_mailbox::try_pop(envelope &out) {
+  if (!_returned.empty()) {
+    out = std::move(_returned.front());
+    _returned.pop_front();
+    _size.fetch_sub(1);
+    return true;
+  }
+
+  auto tail = _tail;
+  auto next = tail->next.load(std::memory_order_acquire);
+  if (next == nullptr) {
+    return false;
+  }
+  // 'next' becomes the new stub node.
+  out = std::move(next->value);
+  _tail = next;
+  _size.fetch_sub(1);
+  delete tail;
+  return true;
+}
+
+size_t mpsc_mailbox::drain(std::vector<envelope> &out, size_t max) {
+  size_t count = 0;
+  while (count < max && !_returned.empty()) {
+    out.emplace_back(std::move(_returned.front()));
+    _returned.pop_front();
+    ++count;
+  }
+
+  auto tail = _tail;
+  while (count < max) {
+    auto next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      break;
+    }
+    out.emplace_back(std::move(next->value));
+    delete tail;
+    tail = next;
+    ++count;
+  }
+  _tail = tail;
+  if (count != 0) {
+    _size.fetch_sub(count);
+  }
+  return count;
+}
+
+void mpsc_mailbox::push_front(envelope_span envelopes) {
+  _returned.insert(_returned.begin(), std::make_move_iterator(envelopes.begin()),
+                   std::make_move_iterator(envelopes.end()));
+  _size.fetch_add(envelopes.size());
+}
+
+priority_mailbox::priority_mailbox(size_t lanes, mailbox_kinds kind) {
+  ENSURE(lanes > 0);
+  _lanes.reserve(lanes);
+  for (size_t i = 0; i < lanes; ++i) {
+    if (kind == mailbox_kinds::MPSC) {
+      _lanes.push_back(std::make_unique<mpsc_mailbox>());
+    } else {
+      _lanes.push_back(std::make_unique<mailbox>());
+    }
+  }
+}
+
+bool priority_mailbox::empty() const {
+  return std::all_of(_lanes.begin(), _lanes.end(),
+                     [](const auto &lane) { return lane->empty(); });
+}
+
+size_t priority_mailbox::size() const {
+  size_t result = 0;
+  for (auto &lane : _lanes) {
+    result += lane->size();
+  }
+  return result;
+}
+
+void priority_mailbox::push(const envelope &e) {
+  lane_of(e).push(e);
+}
+
+void priority_mailbox::push(envelope &&e) {
+  lane_of(e).push(std::move(e));
+}
+
+bool priority_mailbox::try_pop(envelope &out) {
+  for (auto it = _lanes.rbegin(); it != _lanes.rend(); ++it) {
+    if ((*it)->try_pop(out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool priority_mailbox::pop_oldest(envelope &out) {
+  for (auto &lane : _lanes) {
+    if (lane->pop_oldest(out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t priority_mailbox::drain(std::vector<envelope> &out, size_t max) {
+  size_t result = 0;
+  for (auto it = _lanes.rbegin(); it != _lanes.rend() && result < max; ++it) {
+    result += (*it)->drain(out, max - result);
+  }
+  return result;
+}
+
+void priority_mailbox::push_front(envelope_span envelopes) {
+  // each lane gets its envelopes back in the same order.
+  for (auto &lane : _lanes) {
+    for (auto &e : envelopes) {
+      if (&lane_of(e) == lane.get()) {
+        _returned.push_back(std::move(e));
+      }
+    }
+    if (!_returned.empty()) {
+      lane->push_front(envelope_span(_returned));
+      _returned.clear();
+    }
+  }
+}
+
+bounded_mailbox::bounded_mailbox(std::shared_ptr<abstract_mailbox> inner,
+                                 size_t capacity, overflow_policy policy,
+                                 std::chrono::microseconds block_timeout)
+    : _inner(std::move(inner)), _capacity(capacity), _policy(policy),
+      _block_timeout(block_timeout), _size(0), _waiters(0), _dropped_newest(0),
+      _dropped_oldest(0), _rejected(0), _blocked(0), _block_timeouts(0),
+      _dead_letters(0) {
+  ENSURE(_inner != nullptr);
+  ENSURE(_capacity != 0);
+}
+
+bool bounded_mailbox::try_reserve() {
+  if (_size.fetch_add(1) < _capacity) {
+    return true;
+  }
+  _size.fetch_sub(1);
+  return false;
+}
+
+void bounded_mailbox::release(size_t count) {
+  if (count == 0) {
+    return;
+  }
+  _size.fetch_sub(count);
+  // pairs with the increment of _waiters in wait_place().
+  if (_waiters.load() != 0) {
+    std::lock_guard<std::mutex> lg(_block_locker);
+    _block_cond.notify_all();
+  }
+}
+
+bool bounded_mailbox::wait_place() {
+  auto deadline = std::chrono::steady_clock::now() + _block_timeout;
+  std::unique_lock<std::mutex> lock(_block_locker);
+  _waiters.fetch_add(1);
+  auto result = true;
+  while (!try_reserve()) {
+    if (_block_cond.wait_until(lock, deadline) == std::cv_status::timeout) {
+      result = try_reserve();
+      break;
+    }
+  }
+  _waiters.fetch_sub(1);
+  return result;
+}
+
+bool bounded_mailbox::offer(envelope &e) {
+  if (e.priority == system_priority) {
+    // control messages are not dropped.
+    _size.fetch_add(1);
+    _inner->push(std::move(e));
+    return true;
+  }
+  if (try_reserve()) {
+    _inner->push(std::move(e));
+    return true;
+  }
+
+  switch (_policy) {
+  case overflow_policy::DROP_NEWEST:
+    _dropped_newest.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  case overflow_policy::DROP_OLDEST: {
+    // the place of the oldest envelope is taken by the new one.
+    envelope oldest;
+    if (_inner->pop_oldest(oldest)) {
+      _dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // the consumer took all envelopes, but did not release them yet,
+      // or only control messages are left.
+      _size.fetch_add(1);
+    }
+    _inner->push(std::move(e));
+    return true;
+  }
+  case overflow_policy::REJECT:
+    _rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  case overflow_policy::BLOCK:
+    _blocked.fetch_add(1, std::memory_order_relaxed);
+    if (wait_place()) {
+      _inner->push(std::move(e));
+      return true;
+    }
+    _block_timeouts.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  case overflow_policy::DEAD_LETTER:
+    _dead_letters.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return false;
+}
+
+bool bounded_mailbox::try_pop(envelope &out) {
+  if (_inner->try_pop(out)) {
+    release(1);
+    return true;
+  }
+  return false;
+}
+
+size_t bounded_mailbox::drain(std::vector<envelope> &out, size_t max) {
+  auto result = _inner->drain(out, max);
+  release(result);
+  return result;
+}
+
+void bounded_mailbox::push_front(envelope_span envelopes) {
+  // returned envelopes were accepted already, they may exceed the capacity.
+  _size.fetch_add(envelopes.size());
+  _inner->push_front(envelopes);
+}
+
+mailbox_counters bounded_mailbox::counters() const {
+  mailbox_counters result;
+  result.dropped_newest = _dropped_newest.load(std::memory_order_relaxed);
+  result.dropped_oldest = _dropped_oldest.load(std::memory_order_relaxed);
+  result.rejected = _rejected.load(std::memory_order_relaxed);
+  result.blocked = _blocked.load(std::memory_order_relaxed);
+  result.block_timeouts = _block_timeouts.load(std::memory_order_relaxed);
+  result.dead_letters = _dead_letters.load(std::memory_order_relaxed);
+  return result;
+}
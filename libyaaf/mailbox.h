@@ -1,53 +1,282 @@
 #pragma once
 
 #include <libyaaf/envelope.h>
+#include <libyaaf/exports.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
+#include <vector>
 
 namespace yaaf {
-class mailbox {
+
+/// LOCKED - std::deque under a shared_mutex.
+/// MPSC - lock-free queue for many senders and one consumer (the actor).
+enum class mailbox_kinds { LOCKED, MPSC };
+
+/// what a full bounded mailbox does with a new envelope.
+/// DROP_NEWEST - the new envelope is dropped.
+/// DROP_OLDEST - the oldest envelope is dropped, the new one is pushed.
+/// REJECT - the new envelope is dropped, the sender gets mailbox_overflow.
+/// BLOCK - the sender waits for a free place, after the timeout as REJECT.
+/// DEAD_LETTER - the new envelope goes to a dead letters actor as dead_letter.
+enum class overflow_policy { DROP_NEWEST, DROP_OLDEST, REJECT, BLOCK, DEAD_LETTER };
+
+/// sent to the sender of an envelope rejected by a full mailbox of 'target'.
+struct mailbox_overflow {
+  actor_address target;
+};
+
+/// an envelope diverted from a full mailbox of 'target'.
+struct dead_letter {
+  actor_address target;
+  envelope e;
+};
+
+struct mailbox_counters {
+  size_t dropped_newest = 0;
+  size_t dropped_oldest = 0;
+  size_t rejected = 0;
+  /// sends which waited for a free place.
+  size_t blocked = 0;
+  /// sends which waited and were rejected.
+  size_t block_timeouts = 0;
+  size_t dead_letters = 0;
+};
+
+class abstract_mailbox {
+public:
+  virtual ~abstract_mailbox() {}
+
+  virtual bool empty() const = 0;
+  virtual size_t size() const = 0;
+  virtual void push(const envelope &e) = 0;
+  virtual void push(envelope &&e) = 0;
+  /// must be called only from one thread at the same time.
+  virtual bool try_pop(envelope &out) = 0;
+  /// moves up to 'max' envelopes to the end of 'out'. returns count of moved.
+  /// must be called only from one thread at the same time.
+  virtual size_t drain(std::vector<envelope> &out, size_t max) = 0;
+  /// returns not handled envelopes to the head of a queue.
+  /// must be called only from the consumer thread.
+  virtual void push_front(envelope_span envelopes) = 0;
+
+  /// takes the oldest envelope of the lowest priority for DROP_OLDEST of
+  /// bounded_mailbox. envelopes of system_priority are not taken.
+  /// called by senders, false if a mailbox does not support it.
+  virtual bool pop_oldest(envelope &out) {
+    UNUSED(out);
+    return false;
+  }
+
+  /// pushes e, if it fits. e is moved only in this case.
+  virtual bool offer(envelope &e) {
+    push(std::move(e));
+    return true;
+  }
+  virtual mailbox_counters counters() const { return mailbox_counters(); }
+
+  template <class T> void push(T &&t, const actor_address &sender) {
+    envelope ep;
+    ep.payload = std::forward<T>(t);
+    ep.sender = sender;
+    push(std::move(ep));
+  }
+};
+
+class mailbox final : public abstract_mailbox {
 public:
-  bool empty() const {
+  using abstract_mailbox::push;
+
+  bool empty() const override {
     std::shared_lock<std::shared_mutex> lg(_locker);
     return _dqueue.empty();
   }
 
-  size_t size() const {
+  size_t size() const override {
     std::shared_lock<std::shared_mutex> lg(_locker);
     return _dqueue.size();
   }
 
-  void push(const envelope &e) {
+  void push(const envelope &e) override {
     std::lock_guard<std::shared_mutex> lg(_locker);
     _dqueue.emplace_back(e);
   }
 
-  void push(const envelope &&e) {
+  void push(envelope &&e) override {
     std::lock_guard<std::shared_mutex> lg(_locker);
     _dqueue.emplace_back(std::move(e));
   }
 
-  template <class T> void push(T &&t, const actor_address &sender) {
-    std::lock_guard<std::shared_mutex> lg(_locker);
-    envelope ep;
-    ep.payload = std::forward<T>(t);
-    ep.sender = sender;
-    _dqueue.emplace_back(ep);
-  }
-
-  bool try_pop(envelope &out) {
+  bool try_pop(envelope &out) override {
     std::lock_guard<std::shared_mutex> lg(_locker);
     if (_dqueue.empty()) {
       return false;
     } else {
-      out = _dqueue.front();
+      out = std::move(_dqueue.front());
       _dqueue.pop_front();
       return true;
     }
   }
 
+  bool pop_oldest(envelope &out) override {
+    std::lock_guard<std::shared_mutex> lg(_locker);
+    auto it = std::find_if(_dqueue.begin(), _dqueue.end(), [](const envelope &e) {
+      return e.priority != system_priority;
+    });
+    if (it == _dqueue.end()) {
+      return false;
+    }
+    out = std::move(*it);
+    _dqueue.erase(it);
+    return true;
+  }
+
+  size_t drain(std::vector<envelope> &out, size_t max) override {
+    std::lock_guard<std::shared_mutex> lg(_locker);
+    auto count = std::min(max, _dqueue.size());
+    auto last = _dqueue.begin() + count;
+    out.insert(out.end(), std::make_move_iterator(_dqueue.begin()),
+               std::make_move_iterator(last));
+    _dqueue.erase(_dqueue.begin(), last);
+    return count;
+  }
+
+  void push_front(envelope_span envelopes) override {
+    std::lock_guard<std::shared_mutex> lg(_locker);
+    _dqueue.insert(_dqueue.begin(), std::make_move_iterator(envelopes.begin()),
+                   std::make_move_iterator(envelopes.end()));
+  }
+
 private:
   mutable std::shared_mutex _locker;
   std::deque<envelope> _dqueue;
 };
+
+/// intrusive multi-producer single-consumer queue (D.Vyukov).
+/// senders do one atomic exchange, the consumer never blocks senders.
+class mpsc_mailbox final : public abstract_mailbox {
+public:
+  using abstract_mailbox::push;
+
+  EXPORT mpsc_mailbox();
+  EXPORT ~mpsc_mailbox();
+
+  bool empty() const override { return _size.load() == size_t(0); }
+  size_t size() const override { return _size.load(); }
+
+  EXPORT void push(const envelope &e) override;
+  EXPORT void push(envelope &&e) override;
+  EXPORT bool try_pop(envelope &out) override;
+  EXPORT size_t drain(std::vector<envelope> &out, size_t max) override;
+  EXPORT void push_front(envelope_span envelopes) override;
+
+private:
+  struct node {
+    node() = default;
+    explicit node(const envelope &e) : value(e) {}
+    explicit node(envelope &&e) : value(std::move(e)) {}
+
+    std::atomic<node *> next{nullptr};
+    envelope value;
+  };
+
+  void push_node(node *n);
+
+private:
+  alignas(64) std::atomic<node *> _head;
+  alignas(64) node *_tail;
+  std::deque<envelope> _returned; // owned by the consumer, like _tail.
+  alignas(64) std::atomic_size_t _size;
+};
+
+/// mailbox with a queue per priority: drain() and try_pop() take envelopes
+/// of the highest not empty lane first. envelope::priority is a number of a lane,
+/// priorities over the count of lanes go to the top lane.
+class priority_mailbox final : public abstract_mailbox {
+public:
+  using abstract_mailbox::push;
+
+  EXPORT priority_mailbox(size_t lanes, mailbox_kinds kind);
+
+  size_t lanes() const { return _lanes.size(); }
+
+  EXPORT bool empty() const override;
+  EXPORT size_t size() const override;
+  EXPORT void push(const envelope &e) override;
+  EXPORT void push(envelope &&e) override;
+  EXPORT bool try_pop(envelope &out) override;
+  /// from the lowest lane.
+  EXPORT bool pop_oldest(envelope &out) override;
+  EXPORT size_t drain(std::vector<envelope> &out, size_t max) override;
+  EXPORT void push_front(envelope_span envelopes) override;
+
+private:
+  abstract_mailbox &lane_of(const envelope &e) const {
+    return *_lanes[std::min(size_t(e.priority), _lanes.size() - 1)];
+  }
+
+private:
+  std::vector<std::unique_ptr<abstract_mailbox>> _lanes;
+  std::vector<envelope> _returned; // owned by the consumer.
+};
+
+/// mailbox with a capacity over an unbounded one.
+/// a full mailbox applies the policy in offer(), push() ignores the result.
+/// DROP_OLDEST needs a mailbox, where senders may pop: mailbox_kinds::LOCKED.
+class bounded_mailbox final : public abstract_mailbox {
+public:
+  using abstract_mailbox::push;
+
+  EXPORT bounded_mailbox(std::shared_ptr<abstract_mailbox> inner, size_t capacity,
+                         overflow_policy policy,
+                         std::chrono::microseconds block_timeout);
+
+  bool empty() const override { return _inner->empty(); }
+  size_t size() const override { return _inner->size(); }
+  size_t capacity() const { return _capacity; }
+  overflow_policy policy() const { return _policy; }
+
+  void push(const envelope &e) override {
+    envelope copy(e);
+    offer(copy);
+  }
+  void push(envelope &&e) override { offer(e); }
+
+  EXPORT bool offer(envelope &e) override;
+  EXPORT bool try_pop(envelope &out) override;
+  EXPORT size_t drain(std::vector<envelope> &out, size_t max) override;
+  EXPORT void push_front(envelope_span envelopes) override;
+  EXPORT mailbox_counters counters() const override;
+
+private:
+  bool try_reserve();
+  void release(size_t count);
+  bool wait_place();
+
+private:
+  std::shared_ptr<abstract_mailbox> _inner;
+  const size_t _capacity;
+  const overflow_policy _policy;
+  const std::chrono::microseconds _block_timeout;
+
+  /// count of accepted and not taken envelopes.
+  std::atomic_size_t _size;
+
+  std::mutex _block_locker;
+  std::condition_variable _block_cond;
+  std::atomic_size_t _waiters;
+
+  std::atomic_size_t _dropped_newest;
+  std::atomic_size_t _dropped_oldest;
+  std::atomic_size_t _rejected;
+  std::atomic_size_t _blocked;
+  std::atomic_size_t _block_timeouts;
+  std::atomic_size_t _dead_letters;
+};
 } // namespace yaaf
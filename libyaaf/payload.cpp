@@ -0,0 +1,14 @@
+#include <libyaaf/payload.h>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+using namespace yaaf;
+
+size_t payload_t::register_type(const std::type_info &ti) {
+  // called once per type in each module, indexes are kept in the library.
+  static std::mutex locker;
+  static std::unordered_map<std::type_index, size_t> indexes;
+  std::lock_guard<std::mutex> lg(locker);
+  return indexes.emplace(std::type_index(ti), indexes.size()).first->second;
+}
@@ -3,66 +3,287 @@
 #include <libyaaf/exports.h>
 #include <libyaaf/types.h>
 #include <libyaaf/utils/utils.h>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
 
 namespace yaaf {
 
+/// type-erased message value.
+/// small trivially copyable values are stored inline, other values on the heap.
+/// move never copies a value; copy of a not copyable value (std::unique_ptr, ...)
+/// throws an exception.
+/// after share() the value is immutable and owned by a reference counter:
+/// a copy of a shared payload is one atomic increment.
 struct payload_t {
+  static constexpr size_t inline_capacity = 48;
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
 private:
-  struct base_holder {
-    virtual ~base_holder() {}
-    virtual const std::type_info &type_info() const = 0;
-    virtual std::unique_ptr<base_holder> clone() const = 0;
+  struct ops_t {
+    const std::type_info &(*type_info)();
+    /// npos until the first call of type_index_impl<T>::value().
+    std::atomic_size_t *type_index;
+    size_t (*init_type_index)();
+    void (*copy)(const payload_t &from, payload_t &to);
+    void (*move)(payload_t &from, payload_t &to);
+    void (*destroy)(payload_t &p);
+    /// table of the same type in the shared mode, nullptr for shared tables.
+    const ops_t *shared;
   };
 
-  template <typename T> struct holder : base_holder {
-    holder(const T &t) : t_(t) {}
-    const std::type_info &type_info() const override { return typeid(t_); }
+  struct shared_box;
+  static void shared_copy(const payload_t &from, payload_t &to);
+  static void shared_move(payload_t &from, payload_t &to);
+  static void shared_destroy(payload_t &p);
+
+  template <typename T> struct shared_ops_impl;
+
+  template <typename T>
+  using is_inline =
+      std::integral_constant<bool, sizeof(T) <= inline_capacity &&
+                                       alignof(T) <= alignof(std::max_align_t) &&
+                                       std::is_trivially_copyable<T>::value>;
+
+  template <typename T, bool = is_inline<T>::value> struct ops_impl;
+
+  template <typename T> struct type_index_impl {
+    static inline std::atomic_size_t slot{npos};
 
-    std::unique_ptr<base_holder> clone() const override {
-      return std::make_unique<holder<T>>(t_);
+    static size_t value() {
+      auto result = slot.load(std::memory_order_acquire);
+      if (result == npos) {
+        result = register_type(typeid(T));
+        slot.store(result, std::memory_order_release);
+      }
+      return result;
     }
-    T t_;
   };
 
+  template <typename T> struct ops_impl<T, true> {
+    static const std::type_info &type_info() { return typeid(T); }
+    static void copy(const payload_t &from, payload_t &to) {
+      std::memcpy(to._storage.buffer, from._storage.buffer, sizeof(T));
+    }
+    static void move(payload_t &from, payload_t &to) { copy(from, to); }
+    static void destroy(payload_t &) {}
+
+    static constexpr ops_t value{&type_info, &type_index_impl<T>::slot,
+                                 &type_index_impl<T>::value, &copy, &move, &destroy,
+                                 &shared_ops_impl<T>::value};
+  };
+
+  template <typename T> struct ops_impl<T, false> {
+    static const std::type_info &type_info() { return typeid(T); }
+    static void copy(const payload_t &from, payload_t &to) {
+      if constexpr (std::is_copy_constructible<T>::value) {
+        to._storage.ptr = new T(*static_cast<const T *>(from._storage.ptr));
+      } else {
+        UNUSED(from);
+        UNUSED(to);
+        THROW_EXCEPTION("payload: value is not copyable");
+      }
+    }
+    static void move(payload_t &from, payload_t &to) {
+      to._storage.ptr = from._storage.ptr;
+      from._storage.ptr = nullptr;
+    }
+    static void destroy(payload_t &p) { delete static_cast<T *>(p._storage.ptr); }
+
+    static constexpr ops_t value{&type_info, &type_index_impl<T>::slot,
+                                 &type_index_impl<T>::value, &copy, &move, &destroy,
+                                 &shared_ops_impl<T>::value};
+  };
+
+  template <typename T> struct shared_ops_impl {
+    static constexpr ops_t value{&ops_impl<T>::type_info, &type_index_impl<T>::slot,
+                                 &type_index_impl<T>::value, &shared_copy, &shared_move,
+                                 &shared_destroy, nullptr};
+  };
+
+  template <typename T>
+  using enable_if_value_t =
+      std::enable_if_t<!std::is_same<std::decay_t<T>, payload_t>::value>;
+
 public:
-  template <typename T> payload_t(const T &t) : _holder(std::make_unique<holder<T>>(t)) {}
-  payload_t() : _holder(nullptr) {}
-  payload_t(const payload_t &other) : _holder(other._holder->clone()) {}
-  payload_t(payload_t &&other) : _holder(std::move(other._holder)) {
-    other._holder = nullptr;
+  template <typename T, typename = enable_if_value_t<T>> payload_t(T &&t) {
+    using value_t = std::decay_t<T>;
+    if constexpr (is_inline<value_t>::value) {
+      new (_storage.buffer) value_t(std::forward<T>(t));
+    } else {
+      _storage.ptr = new value_t(std::forward<T>(t));
+    }
+    _ops = &ops_impl<value_t>::value;
+  }
+
+  payload_t() : _ops(nullptr) {}
+
+  payload_t(const payload_t &other) : _ops(nullptr) {
+    if (other._ops != nullptr) {
+      other._ops->copy(other, *this);
+      _ops = other._ops;
+    }
+  }
+
+  payload_t(payload_t &&other) noexcept : _ops(nullptr) { move_from(other); }
+
+  ~payload_t() { reset(); }
+
+  payload_t &operator=(const payload_t &other) {
+    if (this != &other) {
+      payload_t tmp(other);
+      swap(*this, tmp);
+    }
+    return *this;
+  }
+
+  payload_t &operator=(payload_t &&other) noexcept {
+    if (this != &other) {
+      reset();
+      move_from(other);
+    }
+    return *this;
+  }
+
+  template <typename U> U cast() const { return get<U>(); }
+
+  template <typename U> const U &get() const {
+    if (!holds<U>()) {
+      throw std::runtime_error("Bad any cast");
+    }
+    return *value_ptr<U>();
   }
-  ~payload_t() {}
 
-  template <typename U> U cast() const {
-    if (typeid(U) != _holder->type_info()) {
+  template <typename U> U &get() {
+    if (!holds<U>()) {
       throw std::runtime_error("Bad any cast");
     }
-    return static_cast<holder<U> *>(_holder.get())->t_;
+    if (is_shared()) {
+      THROW_EXCEPTION("payload: shared value is immutable");
+    }
+    return *const_cast<U *>(value_ptr<U>());
+  }
+
+  /// the caller must check the type, see type_index().
+  template <typename U> const U &get_unchecked() const { return *value_ptr<U>(); }
+
+  /// dense index of the value type: 0, 1, 2... in order of first use.
+  /// the same for a type in all modules, shared or not.
+  size_t type_index() const {
+    ENSURE(_ops != nullptr);
+    auto result = _ops->type_index->load(std::memory_order_acquire);
+    return result != npos ? result : _ops->init_type_index();
   }
 
-  bool empty() const { return _holder == nullptr; }
+  template <typename U> static size_t type_index_of() {
+    return type_index_impl<std::decay_t<U>>::value();
+  }
+
+  bool empty() const { return _ops == nullptr; }
+  bool is_shared() const { return _ops != nullptr && _ops->shared == nullptr; }
+
+  /// moves the value to a reference-counted box. copies of the result share
+  /// one value. does nothing for an empty or an already shared payload.
+  inline void share();
 
   template <typename U> bool is() const {
-    ENSURE(_holder != nullptr);
-    return typeid(U) == _holder->type_info();
+    ENSURE(_ops != nullptr);
+    return holds<U>();
+  }
+
+  void reset() {
+    if (_ops != nullptr) {
+      _ops->destroy(*this);
+      _ops = nullptr;
+    }
   }
 
   friend void swap(payload_t &left, payload_t &right);
 
-  payload_t &operator=(const payload_t &other) {
-    payload_t tmp(other);
-    swap(*this, tmp);
-    return *this;
+private:
+  EXPORT static size_t register_type(const std::type_info &ti);
+
+  template <typename U> bool holds() const {
+    // the same type may have different tables in different modules.
+    return _ops == &ops_impl<U>::value || _ops == &shared_ops_impl<U>::value ||
+           (_ops != nullptr && _ops->type_info() == typeid(U));
+  }
+
+  inline const payload_t &shared_value() const;
+
+  template <typename U> const U *value_ptr() const {
+    if (is_shared()) {
+      return shared_value().value_ptr<U>();
+    }
+    if constexpr (is_inline<U>::value) {
+      return reinterpret_cast<const U *>(_storage.buffer);
+    } else {
+      return static_cast<const U *>(_storage.ptr);
+    }
+  }
+
+  void move_from(payload_t &other) noexcept {
+    if (other._ops != nullptr) {
+      other._ops->move(other, *this);
+      _ops = other._ops;
+      other._ops = nullptr;
+    }
   }
 
 private:
-  std::unique_ptr<base_holder> _holder;
+  const ops_t *_ops;
+  union {
+    void *ptr;
+    alignas(std::max_align_t) unsigned char buffer[inline_capacity];
+  } _storage;
 };
 
+struct payload_t::shared_box {
+  std::atomic_size_t refs;
+  payload_t value;
+};
+
+inline void payload_t::shared_copy(const payload_t &from, payload_t &to) {
+  auto box = static_cast<shared_box *>(from._storage.ptr);
+  box->refs.fetch_add(1, std::memory_order_relaxed);
+  to._storage.ptr = box;
+}
+
+inline void payload_t::shared_move(payload_t &from, payload_t &to) {
+  to._storage.ptr = from._storage.ptr;
+  from._storage.ptr = nullptr;
+}
+
+inline void payload_t::shared_destroy(payload_t &p) {
+  auto box = static_cast<shared_box *>(p._storage.ptr);
+  if (box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete box;
+  }
+}
+
+inline void payload_t::share() {
+  if (_ops == nullptr || is_shared()) {
+    return;
+  }
+  auto shared_ops = _ops->shared;
+  auto box = new shared_box{{1}, std::move(*this)};
+  _storage.ptr = box;
+  _ops = shared_ops;
+}
+
+inline const payload_t &payload_t::shared_value() const {
+  return static_cast<const shared_box *>(_storage.ptr)->value;
+}
+
 inline void swap(payload_t &left, payload_t &right) {
-  using std::swap;
   if (&left != &right) {
-    swap(left._holder, right._holder);
+    payload_t tmp(std::move(left));
+    left = std::move(right);
+    right = std::move(tmp);
   }
 }
 
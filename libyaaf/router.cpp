@@ -0,0 +1,119 @@
+#include <libyaaf/actor_registry.h>
+#include <libyaaf/router.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+
+namespace {
+uint64_t mix(uint64_t x) {
+  // splitmix64 finalizer.
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+} // namespace
+
+router::router(const router_settings &settings,
+               std::function<std::shared_ptr<base_actor>()> factory)
+    : _settings(settings), _factory(std::move(factory)),
+      _routees(std::make_shared<routees_t>()) {
+  if (_settings.kind == routing_kinds::CONSISTENT_HASH && !_settings.key) {
+    THROW_EXCEPTION("router: a key is required for the consistent hashing");
+  }
+}
+
+std::shared_ptr<const router::routees_t> router::routees() const {
+  return std::atomic_load(&_routees);
+}
+
+void router::set_routees(std::vector<actor_ref> routees) {
+  auto result = std::make_shared<routees_t>();
+  result->routees = std::move(routees);
+  if (_settings.kind == routing_kinds::CONSISTENT_HASH) {
+    // a node depends on a number of a routee only: a resize keeps other nodes.
+    result->ring.reserve(result->routees.size() * virtual_nodes);
+    for (uint32_t i = 0; i < result->routees.size(); ++i) {
+      for (uint64_t v = 0; v < virtual_nodes; ++v) {
+        result->ring.emplace_back(mix((uint64_t(i) << 32) | v), i);
+      }
+    }
+    std::sort(result->ring.begin(), result->ring.end());
+  }
+  std::atomic_store(&_routees, std::shared_ptr<const routees_t>(std::move(result)));
+}
+
+std::shared_ptr<description> router::select(const envelope &e) {
+  auto r = routees();
+  auto count = r->routees.size();
+  if (count == 0) {
+    return nullptr;
+  }
+
+  switch (_settings.kind) {
+  case routing_kinds::ROUND_ROBIN: {
+    for (size_t i = 0; i < count; ++i) {
+      auto d = r->routees[_next.fetch_add(1, std::memory_order_relaxed) % count].lock();
+      if (d != nullptr) {
+        return d;
+      }
+    }
+    return nullptr;
+  }
+  case routing_kinds::RANDOM: {
+    thread_local std::minstd_rand gen{std::random_device{}()};
+    auto start = size_t(gen()) % count;
+    for (size_t i = 0; i < count; ++i) {
+      auto d = r->routees[(start + i) % count].lock();
+      if (d != nullptr) {
+        return d;
+      }
+    }
+    return nullptr;
+  }
+  case routing_kinds::SMALLEST_MAILBOX: {
+    std::shared_ptr<description> result;
+    auto smallest = std::numeric_limits<size_t>::max();
+    // the scan starts from a next routee, so equal mailboxes are used in turn.
+    auto start = _next.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+      auto d = r->routees[(start + i) % count].lock();
+      if (d == nullptr) {
+        continue;
+      }
+      auto size = d->mbox->size();
+      if (size < smallest) {
+        smallest = size;
+        result = std::move(d);
+        if (size == 0) {
+          break;
+        }
+      }
+    }
+    return result;
+  }
+  case routing_kinds::CONSISTENT_HASH:
+    return select_by_hash(*r, mix(_settings.key(e)));
+  }
+  return nullptr;
+}
+
+std::shared_ptr<description> router::select_by_hash(const routees_t &r,
+                                                    uint64_t key) const {
+  auto it = std::lower_bound(r.ring.begin(), r.ring.end(),
+                             std::make_pair(key, uint32_t(0)));
+  // a stopped routee passes its keys to the next node of the ring.
+  for (size_t i = 0; i < r.ring.size(); ++i, ++it) {
+    if (it == r.ring.end()) {
+      it = r.ring.begin();
+    }
+    auto d = r.routees[it->second].lock();
+    if (d != nullptr) {
+      return d;
+    }
+  }
+  return nullptr;
+}
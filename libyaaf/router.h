@@ -0,0 +1,72 @@
+#pragma once
+
+#include <libyaaf/actor_ref.h>
+#include <libyaaf/envelope.h>
+#include <libyaaf/exports.h>
+#include <libyaaf/utils/utils.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace yaaf {
+class base_actor;
+
+/// ROUND_ROBIN - routees in turn.
+/// SMALLEST_MAILBOX - a routee with the shortest mailbox.
+/// RANDOM - a random routee.
+/// CONSISTENT_HASH - a routee by router_settings::key, a resize moves only a part
+/// of keys to other routees.
+enum class routing_kinds { ROUND_ROBIN, SMALLEST_MAILBOX, RANDOM, CONSISTENT_HASH };
+
+struct router_settings {
+  routing_kinds kind = routing_kinds::ROUND_ROBIN;
+  size_t routees = 1;
+  /// key of an envelope for routing_kinds::CONSISTENT_HASH.
+  std::function<uint64_t(const envelope &e)> key;
+};
+
+namespace inner {
+struct description;
+
+/// picks a routee in a sender thread, so a routed envelope is pushed to a mailbox
+/// once. routees are an immutable snapshot, a resize publishes a new one.
+class router final : public utils::non_copy {
+public:
+  static const size_t virtual_nodes = 64;
+
+  struct routees_t {
+    std::vector<actor_ref> routees;
+    /// CONSISTENT_HASH: sorted hashes of virtual nodes and numbers of routees.
+    std::vector<std::pair<uint64_t, uint32_t>> ring;
+  };
+
+  EXPORT router(const router_settings &settings,
+                std::function<std::shared_ptr<base_actor>()> factory);
+
+  /// nullptr if there is no alive routee.
+  EXPORT std::shared_ptr<description> select(const envelope &e);
+
+  EXPORT std::shared_ptr<const routees_t> routees() const;
+  EXPORT void set_routees(std::vector<actor_ref> routees);
+
+  const router_settings &settings() const { return _settings; }
+  std::shared_ptr<base_actor> make_routee() const { return _factory(); }
+  /// serializes resizes of the router.
+  std::mutex &resize_locker() { return _resize_locker; }
+
+private:
+  std::shared_ptr<description> select_by_hash(const routees_t &r, uint64_t key) const;
+
+private:
+  router_settings _settings;
+  std::function<std::shared_ptr<base_actor>()> _factory;
+  std::shared_ptr<const routees_t> _routees;
+  std::atomic_size_t _next{0};
+  std::mutex _resize_locker;
+};
+} // namespace inner
+} // namespace yaaf
@@ -0,0 +1,231 @@
+#include <libyaaf/timing_wheel.h>
+#include <algorithm>
+#include <limits>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+
+namespace {
+const uint32_t npos = std::numeric_limits<uint32_t>::max();
+const uint64_t max_ticks =
+    (uint64_t(1) << (timing_wheel::level_bits * timing_wheel::levels)) - 1;
+
+uint64_t make_id(uint32_t generation, uint32_t index) {
+  return (uint64_t(generation) << 32) | index;
+}
+} // namespace
+
+timing_wheel::timing_wheel(std::chrono::microseconds tick, clock::time_point start)
+    : _tick(tick), _start(start), _now(0), _size(0), _allocated(0) {
+  ENSURE(_tick.count() > 0);
+  _heads.fill(npos);
+}
+
+uint64_t timing_wheel::ticks_of(clock::time_point tp) const {
+  if (tp <= _start) {
+    return 0;
+  }
+  return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(tp - _start) /
+                  _tick);
+}
+
+timing_wheel::node &timing_wheel::at(uint32_t index) {
+  return _chunks[index / chunk_size][index % chunk_size];
+}
+
+uint32_t timing_wheel::allocate() {
+  uint32_t result;
+  if (!_free.empty()) {
+    result = _free.back();
+    _free.pop_back();
+  } else {
+    if (_allocated == npos) {
+      THROW_EXCEPTION("timing_wheel: too many timers");
+    }
+    if (_allocated % chunk_size == 0) {
+      _chunks.push_back(std::make_unique<node[]>(chunk_size));
+    }
+    result = _allocated++;
+  }
+  auto &n = at(result);
+  n.generation++;
+  n.active = true;
+  return result;
+}
+
+void timing_wheel::release(uint32_t index) {
+  auto &n = at(index);
+  n.active = false;
+  n.target = actor_ref();
+  n.e = envelope();
+  _free.push_back(index);
+  --_size;
+}
+
+void timing_wheel::link(uint32_t index) {
+  auto &n = at(index);
+  // the lowest level where the deadline and the current tick differ only in
+  // bits of the level.
+  size_t level = 0;
+  while (level + 1 < levels && (n.deadline >> (level_bits * (level + 1))) !=
+                                   (_now >> (level_bits * (level + 1)))) {
+    ++level;
+  }
+  n.slot = uint32_t(level * slots + ((n.deadline >> (level_bits * level)) & (slots - 1)));
+  n.prev = npos;
+  n.next = _heads[n.slot];
+  if (n.next != npos) {
+    at(n.next).prev = index;
+  }
+  _heads[n.slot] = index;
+}
+
+void timing_wheel::unlink(uint32_t index) {
+  auto &n = at(index);
+  if (n.prev == npos) {
+    _heads[n.slot] = n.next;
+  } else {
+    at(n.prev).next = n.next;
+  }
+  if (n.next != npos) {
+    at(n.next).prev = n.prev;
+  }
+}
+
+timer_handle timing_wheel::schedule(const actor_ref &target, envelope &&e,
+                                    clock::time_point deadline,
+                                    std::chrono::microseconds period) {
+  auto period_ticks = uint64_t(0);
+  if (period.count() > 0) {
+    auto rounded_up = (period + _tick - std::chrono::microseconds(1)) / _tick;
+    period_ticks = std::min(max_ticks, uint64_t(rounded_up));
+    // each shot copies the message.
+    e.payload.share();
+  }
+
+  std::lock_guard<std::mutex> lg(_locker);
+  auto t = ticks_of(deadline);
+  if (deadline > _start + _tick * t) {
+    ++t;
+  }
+  t = std::min(std::max(t, _now + 1), _now + max_ticks);
+
+  auto index = allocate();
+  auto &n = at(index);
+  n.target = target;
+  n.e = std::move(e);
+  n.deadline = t;
+  n.period = period_ticks;
+  link(index);
+  ++_size;
+  return timer_handle{make_id(n.generation, index)};
+}
+
+bool timing_wheel::cancel(timer_handle h) {
+  auto index = uint32_t(h.id & npos);
+  auto generation = uint32_t(h.id >> 32);
+
+  std::lock_guard<std::mutex> lg(_locker);
+  if (h.empty() || index >= _allocated) {
+    return false;
+  }
+  auto &n = at(index);
+  if (!n.active || n.generation != generation) {
+    return false;
+  }
+  unlink(index);
+  release(index);
+  return true;
+}
+
+void timing_wheel::cascade(size_t level) {
+  auto &head = _heads[level * slots + ((_now >> (level_bits * level)) & (slots - 1))];
+  auto i = head;
+  head = npos;
+  while (i != npos) {
+    auto next = at(i).next;
+    link(i);
+    i = next;
+  }
+}
+
+void timing_wheel::expire_slot() {
+  auto &head = _heads[_now & (slots - 1)];
+  auto i = head;
+  head = npos;
+  while (i != npos) {
+    auto &n = at(i);
+    auto next = n.next;
+    timer_handle h{make_id(n.generation, i)};
+    if (n.period != 0) {
+      _expired.push_back(expired_t{n.target, n.e, h, true});
+      n.deadline = std::max(n.deadline + n.period, _now + 1);
+      link(i);
+    } else {
+      _expired.push_back(expired_t{std::move(n.target), std::move(n.e), h, false});
+      release(i);
+    }
+    i = next;
+  }
+}
+
+size_t timing_wheel::advance(clock::time_point now, const deliver_t &f) {
+  std::unique_lock<std::mutex> al(_advance_locker, std::try_to_lock);
+  if (!al.owns_lock()) {
+    return 0;
+  }
+
+  auto target = ticks_of(now);
+  {
+    std::lock_guard<std::mutex> lg(_locker);
+    while (_now < target) {
+      if (_size == 0) {
+        _now = target;
+        break;
+      }
+      ++_now;
+      // from the top level: its timers may move to the current slot of a lower level.
+      size_t top = 0;
+      while (top + 1 < levels &&
+             (_now & ((uint64_t(1) << (level_bits * (top + 1))) - 1)) == 0) {
+        ++top;
+      }
+      for (auto level = top; level > 0; --level) {
+        cascade(level);
+      }
+      expire_slot();
+    }
+  }
+
+  auto result = _expired.size();
+  for (auto &x : _expired) {
+    if (!f(x.target, std::move(x.e)) && x.periodic) {
+      cancel(x.h);
+    }
+  }
+  _expired.clear();
+  return result;
+}
+
+timing_wheel::clock::time_point timing_wheel::next_deadline() const {
+  std::lock_guard<std::mutex> lg(_locker);
+  if (_size == 0) {
+    return clock::time_point::max();
+  }
+  // timers of the lowest level are in the current round, others are cascaded
+  // at the end of it.
+  auto round_end = (_now | (slots - 1)) + 1;
+  auto result = round_end;
+  for (auto i = (_now & (slots - 1)) + 1; i < slots; ++i) {
+    if (_heads[i] != npos) {
+      result = round_end - slots + i;
+      break;
+    }
+  }
+  return _start + _tick * result;
+}
+
+size_t timing_wheel::size() const {
+  std::lock_guard<std::mutex> lg(_locker);
+  return _size;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <libyaaf/actor_ref.h>
+#include <libyaaf/envelope.h>
+#include <libyaaf/exports.h>
+#include <libyaaf/utils/utils.h>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace yaaf {
+
+/// handle of a scheduled timer, see abstract_context::cancel_timer.
+struct timer_handle {
+  uint64_t id = 0;
+
+  bool empty() const { return id == 0; }
+};
+
+namespace inner {
+
+/// hierarchical timing wheel: levels of slots, each level is 'slots' times coarser.
+/// a timer is linked to a slot of the level which covers its deadline and moves
+/// to a lower level when the wheel reaches the slot, so insert and cancel are O(1)
+/// and there is no heap of deadlines. a timer never fires before its deadline.
+class timing_wheel final : public utils::non_copy {
+public:
+  using clock = std::chrono::steady_clock;
+  /// false if the target is stopped, a periodic timer is cancelled then.
+  using deliver_t = std::function<bool(const actor_ref &target, envelope &&e)>;
+
+  static const size_t level_bits = 8;
+  static const size_t slots = size_t(1) << level_bits;
+  static const size_t levels = 4;
+  static const size_t chunk_size = 4096;
+
+  EXPORT explicit timing_wheel(std::chrono::microseconds tick,
+                               clock::time_point start = clock::now());
+
+  /// period 0 - a single shot timer. delays longer than max_delay() are clamped.
+  EXPORT timer_handle schedule(const actor_ref &target, envelope &&e,
+                               clock::time_point deadline,
+                               std::chrono::microseconds period);
+  /// false if the timer is already fired or cancelled.
+  EXPORT bool cancel(timer_handle h);
+
+  /// moves the wheel to 'now' and delivers expired timers by f, outside of the lock.
+  /// returns count of delivered messages. concurrent calls return 0.
+  EXPORT size_t advance(clock::time_point now, const deliver_t &f);
+
+  /// no timer fires before the result, the wheel must be advanced at it.
+  EXPORT clock::time_point next_deadline() const;
+
+  EXPORT size_t size() const;
+  std::chrono::microseconds tick() const { return _tick; }
+  std::chrono::microseconds max_delay() const {
+    return _tick * ((uint64_t(1) << (level_bits * levels)) - 1);
+  }
+
+private:
+  struct node {
+    actor_ref target;
+    envelope e;
+    uint64_t deadline = 0;
+    uint64_t period = 0;
+    uint32_t prev = 0;
+    uint32_t next = 0;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    bool active = false;
+  };
+
+  struct expired_t {
+    actor_ref target;
+    envelope e;
+    timer_handle h;
+    bool periodic;
+  };
+
+  uint64_t ticks_of(clock::time_point tp) const;
+  node &at(uint32_t index);
+  uint32_t allocate();
+  void release(uint32_t index);
+  void link(uint32_t index);
+  void unlink(uint32_t index);
+  void cascade(size_t level);
+  void expire_slot();
+
+private:
+  std::chrono::microseconds _tick;
+  clock::time_point _start;
+
+  mutable std::mutex _locker;
+  std::mutex _advance_locker;
+  uint64_t _now;
+  size_t _size;
+  std::array<uint32_t, slots * levels> _heads;
+  std::vector<std::unique_ptr<node[]>> _chunks;
+  uint32_t _allocated;
+  std::vector<uint32_t> _free;
+  std::vector<expired_t> _expired;
+};
+} // namespace inner
+} // namespace yaaf
@@ -0,0 +1,292 @@
+#include <libyaaf/topic_trie.h>
+#include <algorithm>
+
+using namespace yaaf;
+using namespace yaaf::inner;
+
+namespace {
+const std::string one_segment = "*";
+const std::string any_segments = "#";
+} // namespace
+
+topic_trie::topic_trie() : _size(0), _generation(0) {
+  for (auto &g : _scopes) {
+    g.store(0);
+  }
+}
+
+std::vector<std::string> topic_trie::split(const std::string &topic) {
+  std::vector<std::string> result;
+  size_t start = 0;
+  while (start <= topic.size()) {
+    auto end = topic.find('/', start);
+    if (end == std::string::npos) {
+      end = topic.size();
+    }
+    if (end != start) {
+      result.emplace_back(topic, start, end - start);
+    }
+    start = end + 1;
+  }
+  return result;
+}
+
+bool topic_trie::is_pattern(const std::string &topic) {
+  auto segments = split(topic);
+  return std::any_of(segments.begin(), segments.end(), [](const std::string &s) {
+    return s == one_segment || s == any_segments;
+  });
+}
+
+size_t topic_trie::node::position(uint64_t id) const {
+  if (index != nullptr) {
+    auto it = index->find(id);
+    return it == index->end() ? npos : it->second;
+  }
+  for (size_t i = 0; i < subscribers.size(); ++i) {
+    if (subscribers[i].address().get_id().value == id) {
+      return i;
+    }
+  }
+  return npos;
+}
+
+void topic_trie::node::add(const actor_ref &subscriber) {
+  subscribers.push_back(subscriber);
+  if (index == nullptr && subscribers.size() > index_threshold) {
+    index = std::make_unique<std::unordered_map<uint64_t, size_t>>();
+    for (size_t i = 0; i < subscribers.size(); ++i) {
+      index->emplace(subscribers[i].address().get_id().value, i);
+    }
+  } else if (index != nullptr) {
+    index->emplace(subscriber.address().get_id().value, subscribers.size() - 1);
+  }
+}
+
+void topic_trie::node::remove(size_t pos) {
+  // the last subscriber takes the place of the removed one.
+  if (index != nullptr) {
+    index->erase(subscribers[pos].address().get_id().value);
+    if (pos != subscribers.size() - 1) {
+      (*index)[subscribers.back().address().get_id().value] = pos;
+    }
+  }
+  if (pos != subscribers.size() - 1) {
+    subscribers[pos] = std::move(subscribers.back());
+  }
+  subscribers.pop_back();
+  if (subscribers.empty()) {
+    subscribers.shrink_to_fit();
+    index = nullptr;
+  }
+}
+
+bool topic_trie::subscribe(const std::string &pattern, const actor_ref &subscriber) {
+  std::lock_guard<std::shared_mutex> lg(_locker);
+  auto segments = split(pattern);
+  auto *n = &_root;
+  for (auto &s : segments) {
+    auto &child = n->children[s];
+    if (child == nullptr) {
+      child = std::make_unique<node>();
+    }
+    n = child.get();
+  }
+  if (n->position(subscriber.address().get_id().value) != node::npos) {
+    return false;
+  }
+  n->add(subscriber);
+  ++_size;
+  invalidate(segments);
+  return true;
+}
+
+bool topic_trie::unsubscribe(const std::string &pattern, yaaf::id_t subscriber) {
+  std::lock_guard<std::shared_mutex> lg(_locker);
+  auto segments = split(pattern);
+  auto n = const_cast<node *>(find(segments));
+  if (n == nullptr) {
+    return false;
+  }
+  auto pos = n->position(subscriber.value);
+  if (pos == node::npos) {
+    return false;
+  }
+  n->remove(pos);
+  --_size;
+  prune(segments);
+  invalidate(segments);
+  return true;
+}
+
+size_t topic_trie::erase(const std::string &pattern) {
+  std::lock_guard<std::shared_mutex> lg(_locker);
+  auto segments = split(pattern);
+  auto n = const_cast<node *>(find(segments));
+  if (n == nullptr || n->subscribers.empty()) {
+    return 0;
+  }
+  auto result = n->subscribers.size();
+  n->subscribers.clear();
+  n->subscribers.shrink_to_fit();
+  n->index = nullptr;
+  _size -= result;
+  prune(segments);
+  invalidate(segments);
+  return result;
+}
+
+void topic_trie::prune(const std::vector<std::string> &segments) {
+  std::vector<node *> path{&_root};
+  for (auto &s : segments) {
+    path.push_back(path.back()->children.find(s)->second.get());
+  }
+  // empty nodes are removed from the end of the path.
+  for (size_t i = segments.size(); i > 0; --i) {
+    auto n = path[i];
+    if (!n->subscribers.empty() || !n->children.empty()) {
+      break;
+    }
+    path[i - 1]->children.erase(segments[i - 1]);
+  }
+}
+
+size_t topic_trie::nodes() const {
+  std::shared_lock<std::shared_mutex> lg(_locker);
+  size_t result = 0;
+  std::vector<const node *> stack{&_root};
+  while (!stack.empty()) {
+    auto n = stack.back();
+    stack.pop_back();
+    ++result;
+    for (auto &kv : n->children) {
+      stack.push_back(kv.second.get());
+    }
+  }
+  return result;
+}
+
+const topic_trie::node *topic_trie::find(const std::vector<std::string> &segments) const {
+  const node *n = &_root;
+  for (auto &s : segments) {
+    auto it = n->children.find(s);
+    if (it == n->children.end()) {
+      return nullptr;
+    }
+    n = it->second.get();
+  }
+  return n;
+}
+
+topic_trie::subscribers_t topic_trie::subscribers(const std::string &pattern) const {
+  std::shared_lock<std::shared_mutex> lg(_locker);
+  auto n = find(split(pattern));
+  return n == nullptr ? subscribers_t() : n->subscribers;
+}
+
+size_t topic_trie::count(const std::string &pattern) const {
+  std::shared_lock<std::shared_mutex> lg(_locker);
+  auto n = find(split(pattern));
+  return n == nullptr ? 0 : n->subscribers.size();
+}
+
+size_t topic_trie::size() const {
+  std::shared_lock<std::shared_mutex> lg(_locker);
+  return _size;
+}
+
+void topic_trie::collect(const node *n, const std::vector<std::string> &segments,
+                         size_t pos, subscribers_t &out) {
+  auto any = n->children.find(any_segments);
+  if (any != n->children.end()) {
+    // '#' takes 0..all of the rest segments.
+    for (size_t i = pos; i <= segments.size(); ++i) {
+      collect(any->second.get(), segments, i, out);
+    }
+  }
+  if (pos == segments.size()) {
+    out.insert(out.end(), n->subscribers.begin(), n->subscribers.end());
+    return;
+  }
+  auto exact = n->children.find(segments[pos]);
+  if (exact != n->children.end()) {
+    collect(exact->second.get(), segments, pos + 1, out);
+  }
+  auto one = n->children.find(one_segment);
+  if (one != n->children.end()) {
+    collect(one->second.get(), segments, pos + 1, out);
+  }
+}
+
+topic_trie::match_t topic_trie::match(const std::string &topic) const {
+  {
+    std::shared_lock<std::shared_mutex> lg(_cache_locker);
+    auto it = _cache.find(topic);
+    if (it != _cache.end() &&
+        it->second.generation == _generation.load(std::memory_order_acquire) &&
+        it->second.scope_generation ==
+            _scopes[it->second.scope].load(std::memory_order_acquire)) {
+      return it->second.subscribers;
+    }
+  }
+
+  auto result = std::make_shared<subscribers_t>();
+  auto segments = split(topic);
+  auto scope = scope_of(segments);
+  uint64_t generation = 0;
+  uint64_t scope_generation = 0;
+  {
+    std::shared_lock<std::shared_mutex> lg(_locker);
+    generation = _generation.load();
+    scope_generation = _scopes[scope].load();
+    collect(&_root, segments, 0, *result);
+  }
+  auto by_id = [](const actor_ref &a, const actor_ref &b) {
+    return a.address().get_id() < b.address().get_id();
+  };
+  auto same = [](const actor_ref &a, const actor_ref &b) {
+    return a.address().get_id() == b.address().get_id();
+  };
+  std::sort(result->begin(), result->end(), by_id);
+  result->erase(std::unique(result->begin(), result->end(), same), result->end());
+
+  cache_t dropped;
+  {
+    std::lock_guard<std::shared_mutex> lg(_cache_locker);
+    if (generation == _generation.load() && scope_generation == _scopes[scope].load()) {
+      if (_cache.size() >= cache_limit && _cache.find(topic) == _cache.end()) {
+        dropped.swap(_cache);
+      }
+      cached_t c{generation, scope_generation, scope, result};
+      _cache.insert_or_assign(topic, std::move(c));
+    }
+  }
+  return result;
+}
+
+size_t topic_trie::cached() const {
+  std::shared_lock<std::shared_mutex> lg(_cache_locker);
+  auto generation = _generation.load();
+  return std::count_if(_cache.begin(), _cache.end(), [this, generation](const auto &kv) {
+    return kv.second.generation == generation &&
+           kv.second.scope_generation == _scopes[kv.second.scope].load();
+  });
+}
+
+size_t topic_trie::scope_of(const std::vector<std::string> &segments) {
+  if (segments.empty()) {
+    return 0;
+  }
+  return std::hash<std::string>()(segments.front()) % scopes_count;
+}
+
+void topic_trie::invalidate(const std::vector<std::string> &pattern) {
+  // called under the unique lock of the trie. cached sets are replaced by match().
+  // a pattern from a wildcard or without segments may match any topic.
+  if (pattern.empty() || pattern.front() == one_segment ||
+      pattern.front() == any_segments) {
+    _generation.fetch_add(1, std::memory_order_release);
+  } else {
+    _scopes[scope_of(pattern)].fetch_add(1, std::memory_order_release);
+  }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <libyaaf/actor_ref.h>
+#include <libyaaf/exports.h>
+#include <libyaaf/types.h>
+#include <libyaaf/utils/utils.h>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace yaaf {
+namespace inner {
+
+/// subscriptions to hierarchical topics. a topic is a list of segments split by '/',
+/// empty segments are skipped. in a pattern '*' matches one segment, '#' matches
+/// zero or more segments: "/root/net/*", "/prices/#".
+/// match sets of topics are immutable snapshots, cached until the next change of
+/// subscriptions: a publisher takes a snapshot and sends without locks of the trie.
+/// a change does not touch the cache, it makes older sets stale by a generation:
+/// a pattern with a literal first segment stales only topics of this segment (and
+/// of other segments in the same scope), a pattern from a wildcard stales all sets.
+class topic_trie final : public utils::non_copy {
+public:
+  using subscribers_t = std::vector<actor_ref>;
+  using match_t = std::shared_ptr<const subscribers_t>;
+
+  /// a full cache is cleared, stale sets are freed out of locks.
+  static const size_t cache_limit = size_t(1) << 18;
+
+  EXPORT topic_trie();
+
+  /// false if the subscription already exists. subscribe and unsubscribe do not
+  /// scan a big set of subscribers of one pattern.
+  EXPORT bool subscribe(const std::string &pattern, const actor_ref &subscriber);
+  /// false if there is no such subscription.
+  EXPORT bool unsubscribe(const std::string &pattern, id_t subscriber);
+  /// removes all subscriptions of the pattern.
+  EXPORT size_t erase(const std::string &pattern);
+
+  /// subscribers of all patterns, which match the topic. sorted by id, without
+  /// duplicates.
+  EXPORT match_t match(const std::string &topic) const;
+  /// subscribers of exactly this pattern.
+  EXPORT subscribers_t subscribers(const std::string &pattern) const;
+  EXPORT size_t count(const std::string &pattern) const;
+
+  /// count of subscriptions.
+  EXPORT size_t size() const;
+  /// count of nodes, with the root.
+  EXPORT size_t nodes() const;
+  /// count of cached sets of the current generation.
+  EXPORT size_t cached() const;
+
+  EXPORT static bool is_pattern(const std::string &topic);
+
+private:
+  struct cached_t {
+    uint64_t generation;
+    uint64_t scope_generation;
+    size_t scope;
+    match_t subscribers;
+  };
+  using cache_t = std::unordered_map<std::string, cached_t>;
+
+  struct node {
+    static const size_t npos = std::numeric_limits<size_t>::max();
+    /// a set of more subscribers has an index of positions by id.
+    static const size_t index_threshold = 16;
+
+    std::unordered_map<std::string, std::unique_ptr<node>> children;
+    subscribers_t subscribers;
+    std::unique_ptr<std::unordered_map<uint64_t, size_t>> index;
+
+    size_t position(uint64_t id) const;
+    void add(const actor_ref &subscriber);
+    void remove(size_t pos);
+  };
+
+  static std::vector<std::string> split(const std::string &topic);
+  const node *find(const std::vector<std::string> &segments) const;
+  static void collect(const node *n, const std::vector<std::string> &segments,
+                      size_t pos, subscribers_t &out);
+  /// removes empty nodes of the path.
+  void prune(const std::vector<std::string> &segments);
+  /// scope of topics with this first segment.
+  static size_t scope_of(const std::vector<std::string> &segments);
+  void invalidate(const std::vector<std::string> &pattern);
+
+private:
+  mutable std::shared_mutex _locker;
+  node _root;
+  size_t _size;
+
+  /// changed by each change of subscriptions, global or of a scope. a match set,
+  /// which was collected before a change, is not cached, a cached one is stale.
+  static const size_t scopes_count = 64;
+  std::atomic_uint64_t _generation;
+  std::array<std::atomic_uint64_t, scopes_count> _scopes;
+  mutable std::shared_mutex _cache_locker;
+  mutable cache_t _cache;
+};
+} // namespace inner
+} // namespace yaaf
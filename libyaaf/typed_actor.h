@@ -0,0 +1,63 @@
+#pragma once
+
+#include <libyaaf/actor.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace yaaf {
+
+/// actor with a handler for each message type from MSGS.
+/// DERIVED implements public 'void on_message(const T &value, const envelope &e)'
+/// for each T from MSGS. a handler is found by payload_t::type_index(), without
+/// a chain of type checks; the value is passed by reference, without a copy.
+/// a message of other type goes to on_unhandled.
+template <class DERIVED, class... MSGS> class typed_actor : public base_actor {
+  static_assert(sizeof...(MSGS) > 0, "typed_actor: empty list of messages");
+
+public:
+  typed_actor() : _table(&dispatch_table()) {}
+
+  void action_handle(const envelope &e) override {
+    if (!e.payload.empty()) {
+      auto index = e.payload.type_index();
+      if (index < _table->size()) {
+        auto handler = (*_table)[index];
+        if (handler != nullptr) {
+          handler(static_cast<DERIVED *>(this), e);
+          return;
+        }
+      }
+    }
+    on_unhandled(e);
+  }
+
+  /// does nothing by default.
+  virtual void on_unhandled(const envelope &e) { UNUSED(e); }
+
+private:
+  using handler_t = void (*)(DERIVED *self, const envelope &e);
+
+  template <class T> static void call(DERIVED *self, const envelope &e) {
+    self->on_message(e.payload.get_unchecked<T>(), e);
+  }
+
+  /// handlers by type index, one table for all actors of the type.
+  static const std::vector<handler_t> &dispatch_table() {
+    static const std::vector<handler_t> result = [] {
+      std::array<size_t, sizeof...(MSGS)> indexes{payload_t::type_index_of<MSGS>()...};
+      std::array<handler_t, sizeof...(MSGS)> handlers{&typed_actor::call<MSGS>...};
+      std::vector<handler_t> table(*std::max_element(indexes.begin(), indexes.end()) + 1,
+                                   nullptr);
+      for (size_t i = 0; i < indexes.size(); ++i) {
+        table[indexes[i]] = handlers[i];
+      }
+      return table;
+    }();
+    return result;
+  }
+
+private:
+  const std::vector<handler_t> *_table;
+};
+} // namespace yaaf
@@ -12,16 +12,11 @@ struct id_t {
 
   id_t() { value = std::numeric_limits<uint64_t>::max(); }
   id_t(std::uint64_t value_) { value = value_; }
-  id_t(const id_t &other) : value(other.value) {}
+  id_t(const id_t &other) = default;
 
   bool empty() const { return value == std::numeric_limits<uint64_t>::max(); }
 
-  id_t &operator=(const id_t &other) {
-    if (this != &other) {
-      value = other.value;
-    }
-    return *this;
-  }
+  id_t &operator=(const id_t &other) = default;
 
   bool operator==(const id_t other) const { return value == other.value; }
   bool operator!=(const id_t other) const { return value != other.value; }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <libyaaf/utils/utils.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace yaaf {
+namespace utils {
+namespace async {
+
+/// work-stealing deque (Chase, Lev; memory orders from Le, Pop, Cohen, Nardelli).
+/// the owner thread pushes and pops at the bottom, other threads steal from the top.
+/// T must be trivially copyable (a pointer).
+template <class T> class chase_lev_deque final : public utils::non_copy {
+  struct array_t {
+    explicit array_t(size_t c) : capacity(c), items(new std::atomic<T>[c]) {}
+
+    T get(int64_t i) const {
+      return items[static_cast<size_t>(i) & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T v) {
+      items[static_cast<size_t>(i) & (capacity - 1)].store(v, std::memory_order_relaxed);
+    }
+
+    size_t capacity;
+    std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+public:
+  /// capacity must be a power of two.
+  explicit chase_lev_deque(size_t capacity = 256) : _top(0), _bottom(0) {
+    _arrays.emplace_back(new array_t(capacity));
+    _array.store(_arrays.back().get());
+  }
+
+  /// owner only.
+  void push(T v) {
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto t = _top.load(std::memory_order_acquire);
+    auto a = _array.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(a->capacity) - 1) {
+      a = grow(a, b, t);
+    }
+    a->put(b, v);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// owner only.
+  bool pop(T &out) {
+    auto b = _bottom.load(std::memory_order_relaxed) - 1;
+    auto a = _array.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = _top.load(std::memory_order_relaxed);
+    if (t > b) {
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    out = a->get(b);
+    if (t == b) {
+      // the last item: race with thieves.
+      bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed);
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /// any thread.
+  bool steal(T &out) {
+    auto t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = _bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    auto a = _array.load(std::memory_order_acquire);
+    auto v = a->get(t);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    out = v;
+    return true;
+  }
+
+  bool empty() const {
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto t = _top.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+private:
+  array_t *grow(array_t *a, int64_t b, int64_t t) {
+    auto na = new array_t(a->capacity * 2);
+    for (auto i = t; i < b; ++i) {
+      na->put(i, a->get(i));
+    }
+    // thieves may still read the old array, it is freed with the deque.
+    _arrays.emplace_back(na);
+    _array.store(na, std::memory_order_release);
+    return na;
+  }
+
+private:
+  alignas(64) std::atomic<int64_t> _top;
+  alignas(64) std::atomic<int64_t> _bottom;
+  std::atomic<array_t *> _array;
+  std::vector<std::unique_ptr<array_t>> _arrays;
+};
+} // namespace async
+} // namespace utils
+} // namespace yaaf
@@ -0,0 +1,19 @@
+#include <libyaaf/utils/async/idle_strategy.h>
+
+using namespace yaaf::utils::async;
+
+idle_strategy::idle_strategy(size_t spins, std::chrono::microseconds max_park)
+    : _spins(spins), _max_park(max_park), _spin(0), _parked(false), _signaled(false),
+      _stopped(false), _parks(0) {}
+
+void idle_strategy::stop() {
+  std::lock_guard<std::mutex> lg(_locker);
+  _stopped = true;
+  _condition.notify_all();
+}
+
+void idle_strategy::wake_up() {
+  std::lock_guard<std::mutex> lg(_locker);
+  _signaled = true;
+  _condition.notify_all();
+}
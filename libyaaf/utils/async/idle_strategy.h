@@ -0,0 +1,84 @@
+#pragma once
+
+#include <libyaaf/exports.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace yaaf {
+namespace utils {
+namespace async {
+
+/// spin-then-park waiting of a worker, which has nothing to do.
+/// the worker calls idle() after an empty pass and work() after a useful one:
+/// the first 'spins' empty passes only yield, then the worker sleeps until notify(),
+/// the deadline or 'max_park'. max_park == 0 - the worker never sleeps.
+/// notify() is a fence and a load while the worker is not parked.
+class idle_strategy {
+public:
+  using clock = std::chrono::steady_clock;
+
+  EXPORT idle_strategy(size_t spins, std::chrono::microseconds max_park);
+
+  void work() { _spin = 0; }
+
+  /// has_work is checked after the worker is marked as parked, so a notify()
+  /// before that is not lost.
+  template <class F> void idle(clock::time_point deadline, F &&has_work) {
+    if (_max_park.count() == 0) {
+      return;
+    }
+    if (_spin < _spins) {
+      ++_spin;
+      std::this_thread::yield();
+      return;
+    }
+    _spin = 0;
+    std::unique_lock<std::mutex> lock(_locker);
+    _parked.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_signaled && !_stopped && !has_work()) {
+      auto until = std::min(deadline, clock::now() + _max_park);
+      _parks.fetch_add(1, std::memory_order_relaxed);
+      _condition.wait_until(lock, until, [this] { return _signaled || _stopped; });
+    }
+    _signaled = false;
+    _parked.store(false);
+  }
+
+  /// wakes up the parked worker.
+  void notify() {
+    // pairs with the fence in idle().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_parked.load(std::memory_order_relaxed)) {
+      wake_up();
+    }
+  }
+
+  /// wakes up the worker, it will not sleep anymore.
+  EXPORT void stop();
+
+  /// count of sleeps.
+  size_t parks() const { return _parks.load(std::memory_order_relaxed); }
+
+private:
+  EXPORT void wake_up();
+
+private:
+  const size_t _spins;
+  const std::chrono::microseconds _max_park;
+  size_t _spin;
+
+  std::mutex _locker;
+  std::condition_variable _condition;
+  std::atomic_bool _parked;
+  bool _signaled;
+  bool _stopped;
+  std::atomic_size_t _parks;
+};
+} // namespace async
+} // namespace utils
+} // namespace yaaf
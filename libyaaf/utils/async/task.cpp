@@ -5,37 +5,40 @@ using namespace yaaf::utils;
 using namespace yaaf::utils::logging;
 using namespace yaaf::utils::async;
 
-task_wrapper::task_wrapper(task &t, const std::string &_function, const std::string &file,
-                           int line): _tinfo() {
-  priority = TASK_PRIORITY::DEFAULT;
-  _task = t;
+task_wrapper::task_wrapper(const task &t, const char *_function, const char *file,
+                           int line)
+    : task_wrapper(t, _function, file, line, TASK_PRIORITY::DEFAULT) {}
+
+task_wrapper::task_wrapper(const task &t, const char *_function, const char *file,
+                           int line, TASK_PRIORITY p)
+    : task_wrapper(t, _function, file, line, p, TASK_RESULT_MODE::WAITABLE) {}
+
+task_wrapper::task_wrapper(const task &t, const char *_function, const char *file,
+                           int line, TASK_PRIORITY p, TASK_RESULT_MODE mode)
+    : _task(t) {
+  priority = p;
   _parent_function = _function;
   _code_file = file;
   _code_line = line;
-  _result = std::make_shared<task_result>();
-}
-
-task_wrapper::task_wrapper(task &t, const std::string &_function, const std::string &file,
-                           int line, TASK_PRIORITY p)
-    : task_wrapper(t, _function, file, line) {
-  this->priority = p;
+  if (mode == TASK_RESULT_MODE::WAITABLE) {
+    _result = std::make_shared<task_result>();
+  }
 }
 
 CONTINUATION_STRATEGY task_wrapper::apply(const thread_info &ti) {
-  _tinfo.kind = ti.kind;
-  _tinfo.thread_number = ti.thread_number;
-
-  if (worker() == CONTINUATION_STRATEGY::SINGLE) {
-    _result->unlock();
+  if (worker(ti) == CONTINUATION_STRATEGY::SINGLE) {
+    if (_result != nullptr) {
+      _result->unlock();
+    }
     return CONTINUATION_STRATEGY::SINGLE;
   }
 
   return CONTINUATION_STRATEGY::REPEAT;
 }
 
-CONTINUATION_STRATEGY task_wrapper::worker() {
+CONTINUATION_STRATEGY task_wrapper::worker(const thread_info &ti) {
   try {
-    return _task(this->_tinfo);
+    return _task(ti);
   } catch (std::exception &ex) {
     logger_fatal("utils: *** async task exception:", _parent_function,
                  " file:", _code_file, " line:", _code_line);
@@ -46,4 +49,4 @@ CONTINUATION_STRATEGY task_wrapper::worker() {
 
 task_result_ptr task_wrapper::result() const {
   return _result;
-}
\ No newline at end of file
+}
@@ -65,39 +65,46 @@ enum class CONTINUATION_STRATEGY { SINGLE, REPEAT };
 
 using task = std::function<CONTINUATION_STRATEGY(const thread_info &)>;
 
+/// DETACHED - nobody waits for the task, result() returns nullptr.
+enum class TASK_RESULT_MODE { WAITABLE, DETACHED };
+
 class task_wrapper {
 public:
-  EXPORT task_wrapper(task &t, const std::string &_function, const std::string &file,
-                      int line);
-  EXPORT task_wrapper(task &t, const std::string &_function, const std::string &file,
-                      int line, TASK_PRIORITY p);
+  /// _function and file must be string literals (__FUNCTION__, __FILE__).
+  EXPORT task_wrapper(const task &t, const char *_function, const char *file, int line);
+  EXPORT task_wrapper(const task &t, const char *_function, const char *file, int line,
+                      TASK_PRIORITY p);
+  EXPORT task_wrapper(const task &t, const char *_function, const char *file, int line,
+                      TASK_PRIORITY p, TASK_RESULT_MODE mode);
   EXPORT CONTINUATION_STRATEGY apply(const thread_info &ti);
   EXPORT task_result_ptr result() const;
 
   TASK_PRIORITY priority;
+  /// keeps the task alive while it is in a lock-free queue of threads_pool.
+  std::shared_ptr<task_wrapper> self_ref;
 
 private:
   /// return true if need recall.
-  CONTINUATION_STRATEGY worker();
+  CONTINUATION_STRATEGY worker(const thread_info &ti);
 
 private:
-  thread_info _tinfo;
   task_result_ptr _result;
   task _task;
-  std::string _parent_function;
-  std::string _code_file;
+  const char *_parent_function;
+  const char *_code_file;
   int _code_line;
 };
 
 using task_wrapper_ptr = std::shared_ptr<task_wrapper>;
 
-#define wrap_task(t)                                                                     \
-  std::make_shared<task_wrapper>(t, std::string(__FUNCTION__), std::string(__FILE__),    \
-                                 __LINE__)
+#define wrap_task(t) std::make_shared<task_wrapper>(t, __FUNCTION__, __FILE__, __LINE__)
 
 #define wrap_task_with_priority(t, pr)                                                   \
-  std::make_shared<task_wrapper>(t, std::string(__FUNCTION__), std::string(__FILE__),    \
-                                 __LINE__, pr)
+  std::make_shared<task_wrapper>(t, __FUNCTION__, __FILE__, __LINE__, pr)
+
+#define wrap_detached_task(t)                                                            \
+  std::make_shared<task_wrapper>(t, __FUNCTION__, __FILE__, __LINE__,                    \
+                                 TASK_PRIORITY::DEFAULT, TASK_RESULT_MODE::DETACHED)
 } // namespace async
 } // namespace utils
 } // namespace yaaf
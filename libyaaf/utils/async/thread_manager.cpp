@@ -30,6 +30,18 @@ task_result_ptr thread_manager::post(const thread_kind_t kind,
   return target->second->post(task);
 }
 
+task_result_ptr thread_manager::post(const thread_kind_t kind,
+                                     const task_wrapper_ptr &task, size_t worker) {
+  if (_stoping_begin) {
+    return nullptr;
+  }
+  auto target = _pools.find(kind);
+  if (target == _pools.end()) {
+    throw MAKE_EXCEPTION("unknow kind.");
+  }
+  return target->second->post(task, worker);
+}
+
 thread_manager::~thread_manager() {
   stop();
 }
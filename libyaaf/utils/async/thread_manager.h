@@ -26,6 +26,9 @@ public:
   //  return this->post((thread_kind_t)kind, task);
   //}
   EXPORT task_result_ptr post(const thread_kind_t kind, const task_wrapper_ptr &task);
+  /// see threads_pool::post(task, worker).
+  EXPORT task_result_ptr post(const thread_kind_t kind, const task_wrapper_ptr &task,
+                              size_t worker);
 
   size_t active_works() {
     size_t res = 0;
@@ -2,18 +2,59 @@
 #include <libyaaf/utils/logger.h>
 #include <algorithm>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace yaaf::utils;
 using namespace yaaf::utils::logging;
 using namespace yaaf::utils::async;
 
+namespace {
+// pool and number of the current thread, if it is a work-stealing worker.
+thread_local threads_pool *current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+void pin_thread(const threads_pool::params_t &p, size_t num) {
+  if (p.cpus.empty()) {
+    return;
+  }
+  auto cpu = p.cpus[num % p.cpus.size()];
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    logger_warn("threads_pool: thread #", num, " is not pinned to cpu #", cpu);
+  }
+#else
+  logger_warn("threads_pool: pinning to cpu #", cpu, " is not supported");
+#endif
+}
+} // namespace
+
 threads_pool::threads_pool(const params_t &p) : _params(p) {
   ENSURE(_params.threads_count > 0);
   _stop_flag = false;
   _is_stoped = false;
   _task_runned = size_t(0);
+  _ws_queued = size_t(0);
+  _ws_pending = size_t(0);
+  _ws_sleepers = size_t(0);
   _threads.resize(_params.threads_count);
-  for (size_t i = 0; i < _params.threads_count; ++i) {
-    _threads[i] = std::thread{&threads_pool::_pool_logic, this, i};
+  if (_params.queue == queue_kinds::WORK_STEALING) {
+    for (size_t i = 0; i < _params.threads_count; ++i) {
+      _local_queues.emplace_back(std::make_unique<chase_lev_deque<task_wrapper *>>());
+      _affine_queues.emplace_back(std::make_unique<affine_queue>());
+    }
+    for (size_t i = 0; i < _params.threads_count; ++i) {
+      _threads[i] = std::thread{&threads_pool::_work_stealing_logic, this, i};
+    }
+  } else {
+    for (size_t i = 0; i < _params.threads_count; ++i) {
+      _threads[i] = std::thread{&threads_pool::_pool_logic, this, i};
+    }
   }
 }
 
@@ -31,7 +72,22 @@ task_result_ptr threads_pool::post(const task_wrapper_ptr &task) {
   return task->result();
 }
 
+task_result_ptr threads_pool::post(const task_wrapper_ptr &task, size_t worker) {
+  if (this->_is_stoped) {
+    return nullptr;
+  }
+  if (_params.queue == queue_kinds::WORK_STEALING) {
+    ws_push_affine_task(task, worker % _params.threads_count);
+  } else {
+    push_task(task);
+  }
+  return task->result();
+}
+
 void threads_pool::stop() {
+  if (_is_stoped) {
+    return;
+  }
   {
     std::unique_lock<std::shared_mutex> lock(_queue_mutex);
     _stop_flag = true;
@@ -40,10 +96,26 @@ void threads_pool::stop() {
     _condition.notify_all();
     worker.join();
   }
+  // all workers are stopped, so deques may be cleared from this thread.
+  for (auto &q : _local_queues) {
+    task_wrapper *raw = nullptr;
+    while (q->pop(raw)) {
+      raw->self_ref = nullptr;
+    }
+  }
+  for (auto &q : _affine_queues) {
+    q->tasks.clear();
+  }
   _is_stoped = true;
 }
 
 void threads_pool::flush() {
+  if (_params.queue == queue_kinds::WORK_STEALING) {
+    while (_ws_pending.load() != size_t(0)) {
+      std::this_thread::yield();
+    }
+    return;
+  }
   while (true) {
     _condition.notify_one();
     std::unique_lock<std::shared_mutex> lock(_queue_mutex);
@@ -65,6 +137,10 @@ void threads_pool::flush() {
 }
 
 void threads_pool::push_task(const task_wrapper_ptr &at) {
+  if (_params.queue == queue_kinds::WORK_STEALING) {
+    ws_push_task(at, false);
+    return;
+  }
   {
     std::unique_lock<std::shared_mutex> lock(_queue_mutex);
     _in_queue.push_back(at);
@@ -76,6 +152,7 @@ void threads_pool::_pool_logic(size_t num) {
   thread_info ti{};
   ti.kind = _params.kind;
   ti.thread_number = num;
+  pin_thread(_params, num);
 
   while (!_stop_flag) {
     std::shared_ptr<task_wrapper> task = nullptr;
@@ -122,3 +199,179 @@ void threads_pool::_pool_logic(size_t num) {
     --_task_runned;
   }
 }
+
+void threads_pool::ws_push_task(const task_wrapper_ptr &at, bool to_global) {
+  if (at->priority != TASK_PRIORITY::WORKER) {
+    _ws_pending++;
+  }
+  _ws_queued++;
+  if (!to_global && current_pool == this) {
+    at->self_ref = at;
+    _local_queues[current_worker]->push(at.get());
+  } else {
+    std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+    _in_queue.push_back(at);
+  }
+
+  // pairs with the fence in ws_wait_task.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (_ws_sleepers.load() != size_t(0)) {
+    std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+    _condition.notify_one();
+  }
+}
+
+void threads_pool::ws_push_affine_task(const task_wrapper_ptr &at, size_t worker) {
+  if (current_pool == this && current_worker == worker) {
+    ws_push_task(at, false);
+    return;
+  }
+  if (at->priority != TASK_PRIORITY::WORKER) {
+    _ws_pending++;
+  }
+  _ws_queued++;
+  auto &q = *_affine_queues[worker];
+  {
+    std::lock_guard<std::mutex> lg(q.locker);
+    q.tasks.push_back(at);
+    q.size++;
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (_ws_sleepers.load() != size_t(0)) {
+    // the condition is shared, the worker must be among the woken.
+    std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+    _condition.notify_all();
+  }
+}
+
+task_wrapper_ptr threads_pool::ws_take_affine_task(size_t worker) {
+  auto &q = *_affine_queues[worker];
+  if (q.size.load() == size_t(0)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lg(q.locker);
+  if (q.tasks.empty()) {
+    return nullptr;
+  }
+  auto result = std::move(q.tasks.front());
+  q.tasks.pop_front();
+  q.size--;
+  --_ws_queued;
+  return result;
+}
+
+task_wrapper_ptr threads_pool::ws_take_task(size_t num) {
+  auto take_global = [this]() -> task_wrapper_ptr {
+    std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+    if (_in_queue.empty()) {
+      return nullptr;
+    }
+    auto result = std::move(_in_queue.front());
+    _in_queue.pop_front();
+    --_ws_queued;
+    return result;
+  };
+
+  // the injection queue is checked from time to time, even if the deque is not empty.
+  thread_local size_t takes = 0;
+  if (++takes % 61 == 0) {
+    auto result = take_global();
+    if (result != nullptr) {
+      return result;
+    }
+  }
+
+  // the owner takes from the top too: tasks are actors, LIFO order would starve
+  // an actor while two others send messages to each other.
+  task_wrapper *raw = nullptr;
+  if (_local_queues[num]->steal(raw)) {
+    --_ws_queued;
+    return std::move(raw->self_ref);
+  }
+
+  auto result = ws_take_affine_task(num);
+  if (result != nullptr) {
+    return result;
+  }
+
+  result = take_global();
+  if (result != nullptr) {
+    return result;
+  }
+
+  for (size_t i = 1; i < _local_queues.size(); ++i) {
+    auto victim = (num + i) % _local_queues.size();
+    if (_local_queues[victim]->steal(raw)) {
+      --_ws_queued;
+      return std::move(raw->self_ref);
+    }
+  }
+  // an idle worker takes its affine tasks itself.
+  for (size_t i = 1; i < _affine_queues.size(); ++i) {
+    auto victim = (num + i) % _affine_queues.size();
+    if (_affine_queues[victim]->owner_busy.load()) {
+      result = ws_take_affine_task(victim);
+      if (result != nullptr) {
+        return result;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void threads_pool::ws_wait_task(size_t num) {
+  std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+  _ws_sleepers++;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto &own = *_affine_queues[num];
+  bool has_work = _stop_flag || !_in_queue.empty() || own.size.load() != size_t(0) ||
+                  std::any_of(_local_queues.begin(), _local_queues.end(),
+                              [](const auto &q) { return !q->empty(); }) ||
+                  std::any_of(_affine_queues.begin(), _affine_queues.end(),
+                              [](const auto &q) {
+                                return q->owner_busy.load() && q->size.load() != 0;
+                              });
+  if (!has_work) {
+    // timeout is only a safety net, senders wake sleepers up.
+    _condition.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  _ws_sleepers--;
+}
+
+void threads_pool::_work_stealing_logic(size_t num) {
+  thread_info ti{};
+  ti.kind = _params.kind;
+  ti.thread_number = num;
+  current_pool = this;
+  current_worker = num;
+  pin_thread(_params, num);
+  auto &own = *_affine_queues[num];
+
+  while (!_stop_flag) {
+    auto task = ws_take_task(num);
+    if (task == nullptr) {
+      ws_wait_task(num);
+      continue;
+    }
+
+    _task_runned++;
+    own.owner_busy.store(true);
+    if (own.size.load() != size_t(0) && _ws_sleepers.load() != size_t(0)) {
+      // the affine tasks may be stolen now.
+      std::unique_lock<std::shared_mutex> lock(_queue_mutex);
+      _condition.notify_one();
+    }
+    auto need_continue = task->apply(ti);
+    own.owner_busy.store(false);
+    // repeated tasks go to the injection queue, so they don't hide local tasks.
+    if (need_continue == CONTINUATION_STRATEGY::REPEAT) {
+      ws_push_task(task, true);
+    }
+    if (task->priority != TASK_PRIORITY::WORKER) {
+      --_ws_pending;
+    }
+    --_task_runned;
+  }
+  current_pool = nullptr;
+}
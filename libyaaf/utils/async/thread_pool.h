@@ -1,12 +1,14 @@
 #pragma once
 
 #include <libyaaf/exports.h>
+#include <libyaaf/utils/async/chase_lev_deque.h>
 #include <libyaaf/utils/async/locker.h>
 #include <libyaaf/utils/async/task.h>
 #include <libyaaf/utils/utils.h>
 
 #include <algorithm>
 #include <deque>
+#include <mutex>
 #include <shared_mutex>
 
 namespace yaaf {
@@ -15,27 +17,43 @@ namespace async {
 
 using task_queue_t = std::deque<task_wrapper_ptr>;
 
+/// SHARED - one queue for all threads of a pool.
+/// WORK_STEALING - each thread has own deque, tasks posted from outside of a pool
+/// go to a shared injection queue, an idle thread steals from others.
+enum class queue_kinds { SHARED, WORK_STEALING };
+
 class threads_pool final : public utils::non_copy {
 public:
   struct params_t {
     size_t threads_count;
     thread_kind_t kind;
-    params_t(size_t _threads_count, thread_kind_t _kind) {
+    queue_kinds queue;
+    /// thread i is pinned to cpus[i % cpus.size()]. empty - threads are not pinned.
+    std::vector<size_t> cpus;
+    params_t(size_t _threads_count, thread_kind_t _kind,
+             queue_kinds _queue = queue_kinds::SHARED) {
       threads_count = _threads_count;
       kind = _kind;
+      queue = _queue;
     }
   };
   EXPORT threads_pool(const params_t &p);
   EXPORT ~threads_pool();
   EXPORT task_result_ptr post(const task_wrapper_ptr &task);
+  /// WORK_STEALING: the task runs on the worker, an other thread steals it only
+  /// while the worker is busy. SHARED: same as post(task).
+  EXPORT task_result_ptr post(const task_wrapper_ptr &task, size_t worker);
   EXPORT void flush();
   EXPORT void stop();
 
   size_t threads_count() const { return _params.threads_count; }
   thread_kind_t kind() const { return _params.kind; }
-  bool is_stopped() const { return _is_stoped; }
+  bool is_stopped() const { return _is_stoped.load(); }
 
   size_t active_workers() const {
+    if (_params.queue == queue_kinds::WORK_STEALING) {
+      return _ws_queued.load() + _task_runned.load();
+    }
     std::shared_lock<std::shared_mutex> lg(_queue_mutex);
     size_t res = _in_queue.size();
     return res + (_task_runned);
@@ -45,6 +63,13 @@ protected:
   void _pool_logic(size_t num);
   void push_task(const task_wrapper_ptr &at);
 
+  void _work_stealing_logic(size_t num);
+  void ws_push_task(const task_wrapper_ptr &at, bool to_global);
+  void ws_push_affine_task(const task_wrapper_ptr &at, size_t worker);
+  task_wrapper_ptr ws_take_affine_task(size_t worker);
+  task_wrapper_ptr ws_take_task(size_t num);
+  void ws_wait_task(size_t num);
+
 protected:
   params_t _params;
   std::vector<std::thread> _threads;
@@ -52,8 +77,22 @@ protected:
   mutable std::shared_mutex _queue_mutex;
   std::condition_variable_any _condition;
   std::atomic_bool _stop_flag;         // true - pool under stop.
-  bool _is_stoped;                 // true - already stopped.
+  std::atomic_bool _is_stoped;     // true - already stopped.
   std::atomic_size_t _task_runned; // count of runned tasks.
+
+  // WORK_STEALING. _in_queue is the injection queue.
+  std::vector<std::unique_ptr<chase_lev_deque<task_wrapper *>>> _local_queues;
+  /// tasks posted to a worker from outside of it.
+  struct affine_queue {
+    std::mutex locker;
+    task_queue_t tasks;
+    std::atomic_size_t size{0};
+    std::atomic_bool owner_busy{false};
+  };
+  std::vector<std::unique_ptr<affine_queue>> _affine_queues;
+  std::atomic_size_t _ws_queued;  // tasks in all queues.
+  std::atomic_size_t _ws_pending; // not finished tasks with a default priority.
+  std::atomic_size_t _ws_sleepers;
 };
 } // namespace async
 } // namespace utils
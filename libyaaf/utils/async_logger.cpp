@@ -0,0 +1,159 @@
+#include <libyaaf/utils/async_logger.h>
+#include <libyaaf/utils/exception.h>
+#include <chrono>
+#include <cstdint>
+
+using namespace yaaf::utils::logging;
+
+namespace {
+size_t round_up_to_pow2(size_t v) {
+  size_t result = 2;
+  while (result < v) {
+    result <<= 1;
+  }
+  return result;
+}
+
+const char *prefix(message_kind kind) {
+  switch (kind) {
+  case message_kind::fatal:
+    return "[err] ";
+  case message_kind::warn:
+    return "[wrn] ";
+  case message_kind::info:
+    return "[inf] ";
+  case message_kind::message:
+    return "[dbg] ";
+  }
+  return "";
+}
+} // namespace
+
+async_file_logger::async_file_logger(const params_t &p)
+    : _params(p), _enqueue_pos(0), _dequeue_pos(0), _accepted(0), _written(0),
+      _dropped(0), _writer_sleeps(false), _stop_flag(false) {
+  _file = std::fopen(_params.file_name.c_str(), "a");
+  if (_file == nullptr) {
+    THROW_EXCEPTION("async_file_logger: can't open ", _params.file_name);
+  }
+
+  auto capacity = round_up_to_pow2(_params.capacity);
+  _mask = capacity - 1;
+  _ring.reset(new record[capacity]);
+  for (size_t i = 0; i < capacity; ++i) {
+    _ring[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  _writer = std::thread([this]() { this->writer_logic(); });
+}
+
+async_file_logger::~async_file_logger() {
+  {
+    std::lock_guard<std::mutex> lg(_writer_locker);
+    _stop_flag.store(true);
+    _writer_cond.notify_one();
+  }
+  _writer.join();
+  std::fclose(_file);
+}
+
+void async_file_logger::message(message_kind kind, const std::string &msg) noexcept {
+  if (!try_push(kind, msg)) {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  _accepted.fetch_add(1, std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (_writer_sleeps.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lg(_writer_locker);
+    _writer_cond.notify_one();
+  }
+}
+
+void async_file_logger::flush() {
+  auto target = _accepted.load();
+  while (_written.load() < target) {
+    {
+      std::lock_guard<std::mutex> lg(_writer_locker);
+      _writer_cond.notify_one();
+    }
+    std::this_thread::yield();
+  }
+}
+
+// bounded queue of D.Vyukov: a record is free for the writer when
+// seq == pos + 1 and free for senders when seq == pos.
+bool async_file_logger::try_push(message_kind kind, const std::string &msg) noexcept {
+  record *r = nullptr;
+  auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    r = &_ring[pos & _mask];
+    auto seq = r->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = _enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+  r->kind = kind;
+  try {
+    // a record keeps its buffer, so there is no allocation after a warm up.
+    r->msg.assign(msg);
+  } catch (...) {
+    r->msg.clear();
+  }
+  r->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool async_file_logger::try_pop(record *&out) noexcept {
+  auto r = &_ring[_dequeue_pos & _mask];
+  if (r->seq.load(std::memory_order_acquire) != _dequeue_pos + 1) {
+    return false;
+  }
+  out = r;
+  return true;
+}
+
+void async_file_logger::writer_logic() {
+  std::string buffer;
+  for (;;) {
+    size_t count = 0;
+    record *r = nullptr;
+    while (count < _params.batch_size && try_pop(r)) {
+      buffer.append(prefix(r->kind));
+      buffer.append(r->msg);
+      buffer.push_back('\n');
+      r->seq.store(_dequeue_pos + _mask + 1, std::memory_order_release);
+      ++_dequeue_pos;
+      ++count;
+    }
+
+    if (count != 0) {
+      std::fwrite(buffer.data(), 1, buffer.size(), _file);
+      std::fflush(_file);
+      buffer.clear();
+      _written.fetch_add(count);
+      continue;
+    }
+
+    if (_stop_flag.load()) {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lk(_writer_locker);
+    _writer_sleeps.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!try_pop(r) && !_stop_flag.load()) {
+      _writer_cond.wait_for(lk, std::chrono::milliseconds(_params.flush_interval_ms));
+    }
+    _writer_sleeps.store(false, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <libyaaf/exports.h>
+#include <libyaaf/utils/logger.h>
+#include <libyaaf/utils/utils.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace yaaf {
+namespace utils {
+namespace logging {
+
+/// writes messages to a file from a background thread.
+/// senders put records to a bounded ring and never wait for i/o.
+/// if the ring is full, a new record is dropped and counted.
+class async_file_logger final : public abstract_logger, public utils::non_copy {
+public:
+  struct params_t {
+    std::string file_name;
+    /// count of records in the ring. rounded up to a power of two.
+    size_t capacity;
+    /// max count of records in one write.
+    size_t batch_size;
+    /// the writer wakes up at least once per interval.
+    size_t flush_interval_ms;
+
+    static params_t defparams(const std::string &file_name) {
+      params_t result;
+      result.file_name = file_name;
+      result.capacity = 1 << 16;
+      result.batch_size = 1024;
+      result.flush_interval_ms = 100;
+      return result;
+    }
+  };
+
+  EXPORT async_file_logger(const params_t &p);
+  EXPORT ~async_file_logger();
+
+  EXPORT void message(message_kind kind, const std::string &msg) noexcept override;
+  bool thread_safe() const noexcept override { return true; }
+
+  /// waits until all accepted records are written.
+  EXPORT void flush();
+
+  size_t written() const { return _written.load(); }
+  size_t dropped() const { return _dropped.load(); }
+
+private:
+  struct record {
+    std::atomic_size_t seq;
+    message_kind kind;
+    std::string msg;
+  };
+
+  bool try_push(message_kind kind, const std::string &msg) noexcept;
+  bool try_pop(record *&out) noexcept;
+  void writer_logic();
+
+private:
+  params_t _params;
+  std::FILE *_file;
+  std::unique_ptr<record[]> _ring;
+  size_t _mask;
+  alignas(64) std::atomic_size_t _enqueue_pos;
+  alignas(64) size_t _dequeue_pos;
+
+  alignas(64) std::atomic_size_t _accepted;
+  std::atomic_size_t _written;
+  std::atomic_size_t _dropped;
+
+  std::atomic_bool _writer_sleeps;
+  std::atomic_bool _stop_flag;
+  std::mutex _writer_locker;
+  std::condition_variable _writer_cond;
+  std::thread _writer;
+};
+} // namespace logging
+} // namespace utils
+} // namespace yaaf
@@ -7,6 +7,7 @@ using namespace yaaf::utils::async;
 
 std::shared_ptr<logger_manager> logger_manager::_instance = nullptr;
 yaaf::utils::async::locker logger_manager::_locker;
+std::atomic_int logger_manager::_level{static_cast<int>(log_level::all)};
 
 verbose logger_manager::verbose = verbose::debug;
 
@@ -34,11 +35,24 @@ logger_manager *logger_manager::instance() noexcept {
   return tmp;
 }
 
+void logger_manager::set_level(log_level level) noexcept {
+  _level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+log_level logger_manager::level() noexcept {
+  return static_cast<log_level>(_level.load(std::memory_order_relaxed));
+}
+
 logger_manager::logger_manager(abstract_logger_ptr &logger) {
   _logger = logger;
+  _logger_is_thread_safe = _logger->thread_safe();
 }
 
 void logger_manager::message(message_kind kind, const std::string &msg) noexcept {
+  if (_logger_is_thread_safe) {
+    _logger->message(kind, msg);
+    return;
+  }
   std::lock_guard<utils::async::locker> lg(_msg_locker);
   _logger->message(kind, msg);
 }
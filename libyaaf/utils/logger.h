@@ -9,15 +9,27 @@
 #include <mutex>
 #include <string>
 
+/// messages of kinds less than YAAF_LOG_LEVEL are removed at compile time.
+/// values are the same as in log_level.
+#ifndef YAAF_LOG_LEVEL
+#define YAAF_LOG_LEVEL 0
+#endif
+
 namespace yaaf {
 namespace utils {
 namespace logging {
 
 enum class message_kind { message, info, warn, fatal };
 
+/// the minimal kind of written messages.
+enum class log_level { all = 0, info = 1, warn = 2, fatal = 3, off = 4 };
+
 class abstract_logger {
 public:
   virtual void message(message_kind kind, const std::string &msg) noexcept = 0;
+  /// true - message() may be called from many threads at the same time,
+  /// logger_manager does not lock it.
+  virtual bool thread_safe() const noexcept { return false; }
   virtual ~abstract_logger() {}
 };
 
@@ -44,6 +56,14 @@ public:
   EXPORT static void stop();
   EXPORT static logger_manager *instance() noexcept;
 
+  /// runtime filter. checked before a message is formatted.
+  EXPORT static void set_level(log_level level) noexcept;
+  EXPORT static log_level level() noexcept;
+
+  static bool enabled(message_kind kind) noexcept {
+    return static_cast<int>(kind) >= _level.load(std::memory_order_relaxed);
+  }
+
   EXPORT void message(message_kind kind, const std::string &msg) noexcept;
 
   template <typename... T>
@@ -55,28 +75,36 @@ public:
 private:
   static std::shared_ptr<logger_manager> _instance;
   static utils::async::locker _locker;
+  EXPORT static std::atomic_int _level;
   utils::async::locker _msg_locker;
   abstract_logger_ptr _logger;
+  bool _logger_is_thread_safe;
 };
 
+namespace inner {
+template <message_kind kind, typename... T> void log_message(T &&... args) noexcept {
+  if constexpr (static_cast<int>(kind) >= YAAF_LOG_LEVEL) {
+    if (logger_manager::enabled(kind)) {
+      logger_manager::instance()->variadic_message(kind, args...);
+    }
+  }
+}
+} // namespace inner
+
 template <typename... T> void logger(T &&... args) noexcept {
-  yaaf::utils::logging::logger_manager::instance()->variadic_message(
-      yaaf::utils::logging::message_kind::message, args...);
+  inner::log_message<message_kind::message>(args...);
 }
 
 template <typename... T> void logger_info(T &&... args) noexcept {
-  yaaf::utils::logging::logger_manager::instance()->variadic_message(
-      yaaf::utils::logging::message_kind::info, args...);
+  inner::log_message<message_kind::info>(args...);
 }
 
 template <typename... T> void logger_warn(T &&... args) noexcept {
-  yaaf::utils::logging::logger_manager::instance()->variadic_message(
-      yaaf::utils::logging::message_kind::warn, args...);
+  inner::log_message<message_kind::warn>(args...);
 }
 
 template <typename... T> void logger_fatal(T &&... args) noexcept {
-  yaaf::utils::logging::logger_manager::instance()->variadic_message(
-      yaaf::utils::logging::message_kind::fatal, args...);
+  inner::log_message<message_kind::fatal>(args...);
 }
 } // namespace logging
 } // namespace utils
@@ -0,0 +1,79 @@
+#include <libyaaf/envelope.h>
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+
+using namespace yaaf;
+
+namespace {
+/// previous implementation of actor_address: an id and an own copy of the path.
+struct legacy_actor_address {
+  legacy_actor_address() : id(0) {}
+  legacy_actor_address(yaaf::id_t id_, std::string pathname_)
+      : id(id_), pathname(pathname_) {}
+
+  bool operator==(const legacy_actor_address &other) const {
+    return id == other.id && pathname == other.pathname;
+  }
+
+  yaaf::id_t id;
+  std::string pathname;
+};
+
+struct legacy_hash {
+  size_t operator()(const legacy_actor_address &s) const {
+    size_t h_id = std::hash<yaaf::id_t>()(s.id);
+    size_t h_str = std::hash<std::string>()(s.pathname);
+    return h_id ^ (h_str << 1);
+  }
+};
+
+struct legacy_envelope {
+  payload_t payload;
+  legacy_actor_address sender;
+};
+
+const std::string path = "/root/usr/some_parent/some_actor_with_long_name";
+
+template <class A> A make_address();
+template <> legacy_actor_address make_address<legacy_actor_address>() {
+  return legacy_actor_address(yaaf::id_t(42), path);
+}
+template <> actor_address make_address<actor_address>() {
+  return actor_address(yaaf::id_t(42), path);
+}
+
+template <class A> struct envelope_of;
+template <> struct envelope_of<legacy_actor_address> { using type = legacy_envelope; };
+template <> struct envelope_of<actor_address> { using type = envelope; };
+
+template <class A> struct hash_of;
+template <> struct hash_of<legacy_actor_address> { using type = legacy_hash; };
+template <> struct hash_of<actor_address> { using type = std::hash<actor_address>; };
+} // namespace
+
+/// user_context copies an envelope with a new sender on each send.
+template <class A> static void BM_EnvelopeCopy(benchmark::State &state) {
+  using E = typename envelope_of<A>::type;
+  E e{payload_t(int(1)), make_address<A>()};
+  for (auto _ : state) {
+    E cp{e.payload, e.sender};
+    benchmark::DoNotOptimize(cp);
+  }
+  state.counters["envelope_bytes"] = double(sizeof(E));
+  state.counters["address_bytes"] = double(sizeof(A));
+}
+BENCHMARK_TEMPLATE(BM_EnvelopeCopy, legacy_actor_address);
+BENCHMARK_TEMPLATE(BM_EnvelopeCopy, actor_address);
+
+template <class A> static void BM_AddressHashLookup(benchmark::State &state) {
+  std::unordered_map<A, int, typename hash_of<A>::type> m;
+  auto a = make_address<A>();
+  m[a] = 1;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(a));
+  }
+}
+BENCHMARK_TEMPLATE(BM_AddressHashLookup, legacy_actor_address);
+BENCHMARK_TEMPLATE(BM_AddressHashLookup, actor_address);
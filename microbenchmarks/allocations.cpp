@@ -0,0 +1,80 @@
+#include "common.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// all forms of operator new and delete are replaced together and kept in their own
+// translation unit, so new-expressions of the binary are never inlined into free().
+namespace {
+std::atomic_size_t scopes{0};
+std::atomic_size_t allocations_count{0};
+
+void *allocate(size_t size) noexcept {
+  if (scopes.load(std::memory_order_relaxed) != 0) {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocate_or_throw(size_t size) {
+  if (auto p = allocate(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(size_t size) {
+  return allocate_or_throw(size);
+}
+
+void *operator new[](size_t size) {
+  return allocate_or_throw(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+namespace microbenchmark_common {
+allocations_scope::allocations_scope() {
+  scopes.fetch_add(1, std::memory_order_relaxed);
+  _start = allocations_count.load(std::memory_order_relaxed);
+}
+
+allocations_scope::~allocations_scope() {
+  scopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t allocations_scope::count() const {
+  return allocations_count.load(std::memory_order_relaxed) - _start;
+}
+} // namespace microbenchmark_common
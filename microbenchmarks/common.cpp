@@ -7,4 +7,4 @@ void replace_std_logger() {
 
   yaaf::utils::logging::logger_manager::start(_logger);
 }
-} // namespace microbenchmark_common
\ No newline at end of file
+} // namespace microbenchmark_common
@@ -9,4 +9,16 @@ public:
 };
 
 void replace_std_logger();
+
+/// counts operator new calls of all threads of the process while alive.
+/// allocations out of a scope are not counted.
+class allocations_scope {
+public:
+  allocations_scope();
+  ~allocations_scope();
+  size_t count() const;
+
+private:
+  size_t _start;
+};
 } // namespace microbenchmark_common
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include <libyaaf/context.h>
 #include <benchmark/benchmark.h>
+#include <future>
+
+#include "common.h"
 
 using namespace yaaf;
 
-static void BM_Context(benchmark::State &state) {
+static void context_send(benchmark::State &state) {
   auto ctx = std::make_shared<context>(context::params_t::defparams());
 
   auto c1 = [](yaaf::envelope e) {
@@ -14,9 +17,114 @@ static void BM_Context(benchmark::State &state) {
 
   auto c1_addr = ctx->make_actor<actor_for_delegate>("c1", c1);
 
+  microbenchmark_common::allocations_scope allocations_scope;
   for (auto _ : state) {
     ctx->send(c1_addr, int(1));
   }
+  auto allocations = allocations_scope.count();
+  state.counters["allocs_per_send"] = double(allocations) / double(state.iterations());
   ctx = nullptr;
 }
+
+static void BM_Context(benchmark::State &state) {
+  context_send(state);
+}
 BENCHMARK(BM_Context);
+
+static void BM_ContextLogsDisabled(benchmark::State &state) {
+  using yaaf::utils::logging::logger_manager;
+  auto level = logger_manager::level();
+  logger_manager::set_level(yaaf::utils::logging::log_level::off);
+  context_send(state);
+  logger_manager::set_level(level);
+}
+BENCHMARK(BM_ContextLogsDisabled);
+
+static void BM_ContextSendByRef(benchmark::State &state) {
+  auto ctx = std::make_shared<context>(context::params_t::defparams());
+
+  auto c1 = [](yaaf::envelope e) {
+    auto v = e.payload.cast<int>();
+    UNUSED(v);
+    ENSURE(v == 1);
+  };
+
+  auto c1_ref = ctx->get_ref(ctx->make_actor<actor_for_delegate>("c1", c1));
+
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    ctx->send(c1_ref, int(1));
+  }
+  auto allocations = allocations_scope.count();
+  state.counters["allocs_per_send"] = double(allocations) / double(state.iterations());
+  ctx = nullptr;
+}
+BENCHMARK(BM_ContextSendByRef);
+
+/// a send from inside an actor goes through its user_context.
+static void BM_ContextSendFromActor(benchmark::State &state) {
+  auto ctx = std::make_shared<context>(context::params_t::defparams());
+
+  auto c1 = [](const yaaf::envelope &) {};
+  auto c1_addr = ctx->make_actor<actor_for_delegate>("c1", c1);
+  auto sender_addr = ctx->make_actor<actor_for_delegate>("sender", c1);
+  auto sender_ctx = ctx->actor_cast<actor_for_delegate>(sender_addr)->get_context();
+  const std::string body(static_cast<size_t>(state.range(0)), 'x');
+
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    sender_ctx->send(c1_addr, std::string(body));
+  }
+  auto allocations = allocations_scope.count();
+  state.counters["allocs_per_send"] = double(allocations) / double(state.iterations());
+  sender_ctx = nullptr;
+  ctx = nullptr;
+}
+BENCHMARK(BM_ContextSendFromActor)->Arg(8)->Arg(1024);
+
+namespace {
+class echo final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    get_context()->reply(e, e.payload.get<int>());
+  }
+};
+} // namespace
+
+/// request/response by ask: a pooled state, the reply bypasses mailboxes.
+static void BM_ContextAsk(benchmark::State &state) {
+  auto ctx = std::make_shared<context>(context::params_t::defparams());
+  auto echo_addr = ctx->make_actor<echo>("echo");
+
+  const auto timeout = std::chrono::milliseconds(10000);
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    auto f = ctx->ask<int>(echo_addr, int(1), timeout);
+    benchmark::DoNotOptimize(f.get());
+  }
+  auto allocations = allocations_scope.count();
+  state.counters["allocs_per_ask"] = double(allocations) / double(state.iterations());
+  ctx = nullptr;
+}
+BENCHMARK(BM_ContextAsk);
+
+/// request/response without ask: a temporary actor receives the reply.
+static void BM_ContextAskByTemporaryActor(benchmark::State &state) {
+  auto ctx = std::make_shared<context>(context::params_t::defparams());
+  auto echo_addr = ctx->make_actor<echo>("echo");
+
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    std::promise<int> reply;
+    auto result = reply.get_future();
+    auto on_reply = [&reply](const envelope &e) { reply.set_value(e.payload.get<int>()); };
+    auto tmp = ctx->make_actor<actor_for_delegate>("tmp", on_reply);
+    ctx->send_envelope(echo_addr, envelope{int(1), tmp});
+    benchmark::DoNotOptimize(result.get());
+    ctx->stop_actor(tmp);
+  }
+  auto allocations = allocations_scope.count();
+  state.counters["allocs_per_ask"] = double(allocations) / double(state.iterations());
+  ctx = nullptr;
+}
+BENCHMARK(BM_ContextAskByTemporaryActor);
@@ -1,6 +1,9 @@
 #include <libyaaf/context.h>
 #include <benchmark/benchmark.h>
 
+#include <thread>
+#include <vector>
+
 using namespace yaaf;
 
 static void BM_MailBoxIsEmpty(benchmark::State &state) {
@@ -31,3 +34,69 @@ static void BM_MailBoxWriteMove(benchmark::State &state) {
   }
 }
 BENCHMARK(BM_MailBoxWriteMove);
+
+template <class MB> static void BM_MailBoxProducers(benchmark::State &state) {
+  const size_t producers = static_cast<size_t>(state.range(0));
+  const size_t per_producer = 10000;
+  for (auto _ : state) {
+    MB mbox;
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (size_t i = 0; i < producers; ++i) {
+      threads.emplace_back([&mbox, per_producer]() {
+        for (size_t j = 0; j < per_producer; ++j) {
+          mbox.push(int(1), actor_address());
+        }
+      });
+    }
+
+    size_t received = 0;
+    envelope out;
+    while (received != producers * per_producer) {
+      if (mbox.try_pop(out)) {
+        ++received;
+      }
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * producers * per_producer);
+}
+BENCHMARK_TEMPLATE(BM_MailBoxProducers, mailbox)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MailBoxProducers, mpsc_mailbox)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+template <class MB> static void BM_MailBoxDrain(benchmark::State &state) {
+  const size_t batch = static_cast<size_t>(state.range(0));
+  const size_t count = 1024;
+  MB mbox;
+  std::vector<envelope> out;
+  out.reserve(batch);
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (size_t i = 0; i < count; ++i) {
+      mbox.push(int(1), actor_address());
+    }
+    state.ResumeTiming();
+    if (batch == 1) {
+      envelope el;
+      while (mbox.try_pop(el)) {
+        benchmark::DoNotOptimize(el);
+      }
+    } else {
+      while (mbox.drain(out, batch) != 0) {
+        benchmark::DoNotOptimize(out.data());
+        out.clear();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_MailBoxDrain, mailbox)->Arg(1)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_MailBoxDrain, mpsc_mailbox)->Arg(1)->Arg(16)->Arg(64);
@@ -0,0 +1,104 @@
+#include <libyaaf/payload.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yaaf;
+
+namespace {
+/// previous implementation of payload_t: one heap holder per value, copy clones it.
+struct legacy_payload_t {
+private:
+  struct base_holder {
+    virtual ~base_holder() {}
+    virtual std::unique_ptr<base_holder> clone() const = 0;
+  };
+
+  template <typename T> struct holder : base_holder {
+    holder(const T &t) : t_(t) {}
+    std::unique_ptr<base_holder> clone() const override {
+      return std::make_unique<holder<T>>(t_);
+    }
+    T t_;
+  };
+
+public:
+  template <typename T> legacy_payload_t(const T &t) : _holder(std::make_unique<holder<T>>(t)) {}
+  legacy_payload_t(const legacy_payload_t &other) : _holder(other._holder->clone()) {}
+  legacy_payload_t(legacy_payload_t &&other) : _holder(std::move(other._holder)) {}
+
+private:
+  std::unique_ptr<base_holder> _holder;
+};
+
+struct pod32 {
+  char data[32];
+};
+
+template <class T> T make_value();
+template <> int make_value<int>() { return 1; }
+template <> pod32 make_value<pod32>() { return pod32{}; }
+template <> std::string make_value<std::string>() { return std::string(1024, 'x'); }
+} // namespace
+
+/// the same steps as a send: a payload is created, moved to an envelope
+/// and copied to a mailbox.
+template <class P, class T> static void BM_PayloadSend(benchmark::State &state) {
+  auto v = make_value<T>();
+  for (auto _ : state) {
+    P p(v);
+    P in_envelope(std::move(p));
+    P in_mailbox(in_envelope);
+    benchmark::DoNotOptimize(in_mailbox);
+  }
+}
+BENCHMARK_TEMPLATE(BM_PayloadSend, legacy_payload_t, int);
+BENCHMARK_TEMPLATE(BM_PayloadSend, payload_t, int);
+BENCHMARK_TEMPLATE(BM_PayloadSend, legacy_payload_t, pod32);
+BENCHMARK_TEMPLATE(BM_PayloadSend, payload_t, pod32);
+BENCHMARK_TEMPLATE(BM_PayloadSend, legacy_payload_t, std::string);
+BENCHMARK_TEMPLATE(BM_PayloadSend, payload_t, std::string);
+
+template <class P, class T> static void BM_PayloadMove(benchmark::State &state) {
+  auto v = make_value<T>();
+  for (auto _ : state) {
+    P p(v);
+    P in_envelope(std::move(p));
+    P in_mailbox(std::move(in_envelope));
+    benchmark::DoNotOptimize(in_mailbox);
+  }
+}
+BENCHMARK_TEMPLATE(BM_PayloadMove, legacy_payload_t, int);
+BENCHMARK_TEMPLATE(BM_PayloadMove, payload_t, int);
+BENCHMARK_TEMPLATE(BM_PayloadMove, legacy_payload_t, pod32);
+BENCHMARK_TEMPLATE(BM_PayloadMove, payload_t, pod32);
+BENCHMARK_TEMPLATE(BM_PayloadMove, legacy_payload_t, std::string);
+BENCHMARK_TEMPLATE(BM_PayloadMove, payload_t, std::string);
+
+/// one published value is copied to each subscriber.
+template <bool Shared> static void BM_PayloadFanOut(benchmark::State &state) {
+  const size_t subscribers = static_cast<size_t>(state.range(0));
+  const std::string body(static_cast<size_t>(state.range(1)), 'x');
+  std::vector<payload_t> mailboxes(subscribers);
+  for (auto _ : state) {
+    payload_t published(body);
+    if (Shared) {
+      published.share();
+    }
+    for (auto &m : mailboxes) {
+      m = published;
+    }
+    benchmark::DoNotOptimize(mailboxes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * subscribers);
+}
+BENCHMARK_TEMPLATE(BM_PayloadFanOut, false)
+    ->Args({10, 64})
+    ->Args({500, 64})
+    ->Args({500, 4096});
+BENCHMARK_TEMPLATE(BM_PayloadFanOut, true)
+    ->Args({10, 64})
+    ->Args({500, 64})
+    ->Args({500, 4096});
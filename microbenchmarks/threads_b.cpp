@@ -1,6 +1,8 @@
 #include <libyaaf/utils/async/thread_manager.h>
 #include <benchmark/benchmark.h>
 
+#include "common.h"
+
 using namespace yaaf;
 using namespace yaaf::utils::async;
 
@@ -28,3 +30,112 @@ BENCHMARK_DEFINE_F(ThreadPool_b, repeated)(benchmark::State &state) {
   }
 }
 BENCHMARK_REGISTER_F(ThreadPool_b, repeated);
+
+/// each root task posts children from a worker thread, like actors sending messages.
+template <queue_kinds Q> static void BM_ThreadPoolThroughput(benchmark::State &state) {
+  const size_t threads = static_cast<size_t>(state.range(0));
+  const size_t children = 1000;
+  threads_pool pool(threads_pool::params_t(threads, tk, Q));
+
+  std::atomic_size_t done = 0;
+  task child = [&done](const thread_info &) {
+    done++;
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+  task root = [&pool, &child, children](const thread_info &) {
+    for (size_t i = 0; i < children; ++i) {
+      pool.post(wrap_task(child));
+    }
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+
+  for (auto _ : state) {
+    done = 0;
+    for (size_t i = 0; i < threads; ++i) {
+      pool.post(wrap_task(root));
+    }
+    while (done.load() != threads * children) {
+      std::this_thread::yield();
+    }
+  }
+  pool.stop();
+  state.SetItemsProcessed(state.iterations() * threads * children);
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolThroughput, queue_kinds::SHARED)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolThroughput, queue_kinds::WORK_STEALING)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+
+/// time from a post to the end of the task, while other threads are idle.
+template <queue_kinds Q> static void BM_ThreadPoolLatency(benchmark::State &state) {
+  const size_t threads = static_cast<size_t>(state.range(0));
+  threads_pool pool(threads_pool::params_t(threads, tk, Q));
+
+  task at = [](const thread_info &) { return CONTINUATION_STRATEGY::SINGLE; };
+  for (auto _ : state) {
+    pool.post(wrap_task(at))->wait();
+  }
+  pool.stop();
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolLatency, queue_kinds::SHARED)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolLatency, queue_kinds::WORK_STEALING)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+
+/// one task object is posted again and again, like an actor run task.
+template <queue_kinds Q> static void BM_ThreadPoolPostDetached(benchmark::State &state) {
+  threads_pool pool(threads_pool::params_t(1, tk, Q));
+  std::atomic_size_t done = 0;
+  task at = [&done](const thread_info &) {
+    done++;
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+  auto detached = wrap_detached_task(at);
+
+  size_t posted = 0;
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    pool.post(detached);
+    ++posted;
+    while (done.load() != posted) {
+      std::this_thread::yield();
+    }
+  }
+  auto allocations = allocations_scope.count();
+  pool.stop();
+  state.counters["allocs_per_post"] = double(allocations) / double(posted);
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolPostDetached, queue_kinds::SHARED);
+BENCHMARK_TEMPLATE(BM_ThreadPoolPostDetached, queue_kinds::WORK_STEALING);
+
+template <queue_kinds Q> static void BM_ThreadPoolPostWrapped(benchmark::State &state) {
+  threads_pool pool(threads_pool::params_t(1, tk, Q));
+  std::atomic_size_t done = 0;
+  task at = [&done](const thread_info &) {
+    done++;
+    return CONTINUATION_STRATEGY::SINGLE;
+  };
+
+  size_t posted = 0;
+  microbenchmark_common::allocations_scope allocations_scope;
+  for (auto _ : state) {
+    pool.post(wrap_task(at));
+    ++posted;
+    while (done.load() != posted) {
+      std::this_thread::yield();
+    }
+  }
+  auto allocations = allocations_scope.count();
+  pool.stop();
+  state.counters["allocs_per_post"] = double(allocations) / double(posted);
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolPostWrapped, queue_kinds::SHARED);
+BENCHMARK_TEMPLATE(BM_ThreadPoolPostWrapped, queue_kinds::WORK_STEALING);
@@ -0,0 +1,139 @@
+#include <libyaaf/timing_wheel.h>
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace yaaf;
+using yaaf::inner::timing_wheel;
+
+namespace {
+const size_t outstanding = 1000000;
+
+/// ordered timer queue: O(log n) insert and cancel.
+class tree_timers {
+public:
+  using clock = timing_wheel::clock;
+  using iterator = std::multimap<clock::time_point, envelope>::iterator;
+
+  iterator schedule(clock::time_point deadline, envelope &&e) {
+    return _timers.emplace(deadline, std::move(e));
+  }
+  void cancel(iterator it) { _timers.erase(it); }
+
+  size_t advance(clock::time_point now) {
+    size_t result = 0;
+    auto end = _timers.upper_bound(now);
+    for (auto it = _timers.begin(); it != end; ++it) {
+      benchmark::DoNotOptimize(it->second);
+      ++result;
+    }
+    _timers.erase(_timers.begin(), end);
+    return result;
+  }
+
+private:
+  std::multimap<clock::time_point, envelope> _timers;
+};
+
+std::vector<std::chrono::milliseconds> random_delays(size_t count, size_t max_ms) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> dist(1, max_ms);
+  std::vector<std::chrono::milliseconds> result(count);
+  for (auto &d : result) {
+    d = std::chrono::milliseconds(dist(gen));
+  }
+  return result;
+}
+
+const actor_ref target(actor_address(yaaf::id_t(1), "/root/usr/target"), {});
+} // namespace
+
+/// a session timeout is cancelled and a new one is scheduled, 1M timers are pending.
+static void BM_TimerScheduleCancel_wheel(benchmark::State &state) {
+  auto start = timing_wheel::clock::now();
+  timing_wheel wheel(std::chrono::milliseconds(1), start);
+  auto delays = random_delays(outstanding, 600000);
+  std::vector<timer_handle> handles;
+  handles.reserve(outstanding);
+  for (auto d : delays) {
+    handles.push_back(wheel.schedule(target, envelope{int(1), actor_address()},
+                                     start + d, std::chrono::milliseconds(0)));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto pos = i++ % outstanding;
+    wheel.cancel(handles[pos]);
+    handles[pos] = wheel.schedule(target, envelope{int(1), actor_address()},
+                                  start + delays[pos], std::chrono::milliseconds(0));
+  }
+}
+BENCHMARK(BM_TimerScheduleCancel_wheel);
+
+static void BM_TimerScheduleCancel_tree(benchmark::State &state) {
+  auto start = timing_wheel::clock::now();
+  tree_timers timers;
+  auto delays = random_delays(outstanding, 600000);
+  std::vector<tree_timers::iterator> handles;
+  handles.reserve(outstanding);
+  for (auto d : delays) {
+    handles.push_back(timers.schedule(start + d, envelope{int(1), actor_address()}));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto pos = i++ % outstanding;
+    timers.cancel(handles[pos]);
+    handles[pos] =
+        timers.schedule(start + delays[pos], envelope{int(1), actor_address()});
+  }
+}
+BENCHMARK(BM_TimerScheduleCancel_tree);
+
+/// 1M timers expire over one second of the wheel time.
+static void BM_TimerExpire_wheel(benchmark::State &state) {
+  auto delays = random_delays(outstanding, 1000);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto start = timing_wheel::clock::now();
+    timing_wheel wheel(std::chrono::milliseconds(1), start);
+    for (auto d : delays) {
+      wheel.schedule(target, envelope{int(1), actor_address()}, start + d,
+                     std::chrono::milliseconds(0));
+    }
+    state.ResumeTiming();
+
+    size_t fired = 0;
+    auto deliver = [](const actor_ref &, envelope &&e) {
+      benchmark::DoNotOptimize(e);
+      return true;
+    };
+    for (int ms = 1; ms <= 1000; ++ms) {
+      fired += wheel.advance(start + std::chrono::milliseconds(ms), deliver);
+    }
+    ENSURE(fired == outstanding);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations() * outstanding));
+}
+BENCHMARK(BM_TimerExpire_wheel)->Unit(benchmark::kMillisecond);
+
+static void BM_TimerExpire_tree(benchmark::State &state) {
+  auto delays = random_delays(outstanding, 1000);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto start = timing_wheel::clock::now();
+    auto timers = std::make_unique<tree_timers>();
+    for (auto d : delays) {
+      timers->schedule(start + d, envelope{int(1), actor_address()});
+    }
+    state.ResumeTiming();
+
+    size_t fired = 0;
+    for (int ms = 1; ms <= 1000; ++ms) {
+      fired += timers->advance(start + std::chrono::milliseconds(ms));
+    }
+    ENSURE(fired == outstanding);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations() * outstanding));
+}
+BENCHMARK(BM_TimerExpire_tree)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,184 @@
+#include <libyaaf/topic_trie.h>
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+using yaaf::inner::topic_trie;
+
+namespace {
+const size_t topics_count = 100000;
+const size_t sectors = 100;
+
+std::vector<std::string> make_topics() {
+  std::vector<std::string> result;
+  result.reserve(topics_count);
+  for (size_t i = 0; i < topics_count; ++i) {
+    result.push_back("/prices/s" + std::to_string(i % sectors) + "/" + std::to_string(i));
+  }
+  return result;
+}
+
+/// 10 subscribers of each sector, one of all prices.
+std::vector<std::string> make_patterns() {
+  std::vector<std::string> result;
+  for (size_t i = 0; i < sectors * 10; ++i) {
+    result.push_back("/prices/s" + std::to_string(i % sectors) + "/*");
+  }
+  result.push_back("/prices/#");
+  return result;
+}
+
+yaaf::actor_ref subscriber(size_t i) {
+  return yaaf::actor_ref(yaaf::actor_address(yaaf::id_t(i), "/root/usr/s"), {});
+}
+
+std::vector<std::string> split(const std::string &s) {
+  std::vector<std::string> result;
+  size_t start = 0;
+  while (start < s.size()) {
+    auto end = s.find('/', start);
+    if (end == std::string::npos) {
+      end = s.size();
+    }
+    if (end != start) {
+      result.push_back(s.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return result;
+}
+
+/// a filter in action_handle of a subscriber of all messages.
+bool filter(const std::vector<std::string> &pattern, const std::vector<std::string> &t) {
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    if (pattern[i] == "#") {
+      return true;
+    }
+    if (i == t.size() || (pattern[i] != "*" && pattern[i] != t[i])) {
+      return false;
+    }
+  }
+  return pattern.size() == t.size();
+}
+} // namespace
+
+/// subscribers of a topic are found once, next publishes take the cached set.
+static void BM_TopicMatch_trie(benchmark::State &state) {
+  auto topics = make_topics();
+  topic_trie trie;
+  auto patterns = make_patterns();
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    trie.subscribe(patterns[i], subscriber(i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto m = trie.match(topics[i++ % topics_count]);
+    benchmark::DoNotOptimize(m);
+  }
+}
+BENCHMARK(BM_TopicMatch_trie);
+
+/// each publish walks the trie.
+static void BM_TopicMatch_trie_cold(benchmark::State &state) {
+  auto topics = make_topics();
+  topic_trie trie;
+  auto patterns = make_patterns();
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    trie.subscribe(patterns[i], subscriber(i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    if (i % topics_count == 0) {
+      state.PauseTiming();
+      // drops cached sets of the scope.
+      trie.subscribe("/prices/dummy", subscriber(patterns.size()));
+      trie.unsubscribe("/prices/dummy", yaaf::id_t(patterns.size()));
+      state.ResumeTiming();
+    }
+    auto m = trie.match(topics[i++ % topics_count]);
+    benchmark::DoNotOptimize(m);
+  }
+}
+BENCHMARK(BM_TopicMatch_trie_cold);
+
+/// every subscriber gets every message and filters it.
+static void BM_TopicMatch_filter(benchmark::State &state) {
+  auto topics = make_topics();
+  std::vector<std::vector<std::string>> patterns;
+  for (auto &p : make_patterns()) {
+    patterns.push_back(split(p));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto t = split(topics[i++ % topics_count]);
+    size_t matched = 0;
+    for (auto &p : patterns) {
+      matched += filter(p, t);
+    }
+    benchmark::DoNotOptimize(matched);
+  }
+}
+BENCHMARK(BM_TopicMatch_filter);
+
+/// subscribe and unsubscribe of one actor in a set of state.range(0) subscribers.
+static void BM_TopicSubscribe_churn(benchmark::State &state) {
+  topic_trie trie;
+  auto count = size_t(state.range(0));
+  for (size_t i = 0; i < count; ++i) {
+    trie.subscribe("/prices/usd", subscriber(i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto id = i++ % count;
+    trie.unsubscribe("/prices/usd", yaaf::id_t(id));
+    trie.subscribe("/prices/usd", subscriber(id));
+  }
+}
+BENCHMARK(BM_TopicSubscribe_churn)->Arg(8)->Arg(1000)->Arg(100000);
+
+/// the same churn with state.range(0) cached topics, each iteration publishes once.
+static void BM_TopicSubscribe_churn_warm(benchmark::State &state) {
+  auto topics = make_topics();
+  topic_trie trie;
+  auto patterns = make_patterns();
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    trie.subscribe(patterns[i], subscriber(i));
+  }
+  auto cached = std::min(size_t(state.range(0)), topics_count);
+  for (size_t i = 0; i < cached; ++i) {
+    trie.match(topics[i]);
+  }
+  auto id = patterns.size();
+  size_t i = 0;
+  for (auto _ : state) {
+    trie.subscribe("/prices/usd", subscriber(id));
+    trie.unsubscribe("/prices/usd", yaaf::id_t(id));
+    auto m = trie.match(topics[i++ % cached]);
+    benchmark::DoNotOptimize(m);
+  }
+}
+BENCHMARK(BM_TopicSubscribe_churn_warm)->Arg(1000)->Arg(100000);
+
+/// the same with churn of other topics: cached sets of prices are not stale.
+static void BM_TopicSubscribe_churn_other(benchmark::State &state) {
+  auto topics = make_topics();
+  topic_trie trie;
+  auto patterns = make_patterns();
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    trie.subscribe(patterns[i], subscriber(i));
+  }
+  auto cached = std::min(size_t(state.range(0)), topics_count);
+  for (size_t i = 0; i < cached; ++i) {
+    trie.match(topics[i]);
+  }
+  auto id = patterns.size();
+  size_t i = 0;
+  for (auto _ : state) {
+    trie.subscribe("/orders/usd", subscriber(id));
+    trie.unsubscribe("/orders/usd", yaaf::id_t(id));
+    auto m = trie.match(topics[i++ % cached]);
+    benchmark::DoNotOptimize(m);
+  }
+}
+BENCHMARK(BM_TopicSubscribe_churn_other)->Arg(1000)->Arg(100000);
@@ -0,0 +1,65 @@
+#include <libyaaf/typed_actor.h>
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+using namespace yaaf;
+
+namespace {
+template <size_t I> struct msg {
+  int value;
+};
+
+/// the usual handler: a chain of is<T>() checks.
+template <class SEQ> class if_chain_actor;
+template <size_t... I>
+class if_chain_actor<std::index_sequence<I...>> final : public base_actor {
+public:
+  void action_handle(const envelope &e) override {
+    (void)((e.payload.is<msg<I>>() && (summ += e.payload.cast<msg<I>>().value, true)) ||
+           ...);
+  }
+  int summ = 0;
+};
+
+template <class SEQ> class typed_msg_actor;
+template <size_t... I>
+class typed_msg_actor<std::index_sequence<I...>> final
+    : public typed_actor<typed_msg_actor<std::index_sequence<I...>>, msg<I>...> {
+public:
+  template <size_t N> void on_message(const msg<N> &m, const envelope &) {
+    summ += m.value;
+  }
+  int summ = 0;
+};
+
+/// envelopes with all N types, each type in turn.
+template <size_t... I> std::vector<envelope> make_envelopes(std::index_sequence<I...>) {
+  std::vector<envelope> result;
+  for (size_t round = 0; round < 4; ++round) {
+    (result.push_back(envelope{payload_t(msg<I>{1}), actor_address()}), ...);
+  }
+  return result;
+}
+} // namespace
+
+template <template <class> class A, size_t N>
+static void BM_ActorDispatch(benchmark::State &state) {
+  using seq = std::make_index_sequence<N>;
+  A<seq> actor;
+  auto envelopes = make_envelopes(seq{});
+  for (auto _ : state) {
+    for (auto &e : envelopes) {
+      actor.action_handle(e);
+    }
+  }
+  benchmark::DoNotOptimize(actor.summ);
+  state.SetItemsProcessed(state.iterations() * envelopes.size());
+}
+BENCHMARK_TEMPLATE(BM_ActorDispatch, if_chain_actor, 2);
+BENCHMARK_TEMPLATE(BM_ActorDispatch, typed_msg_actor, 2);
+BENCHMARK_TEMPLATE(BM_ActorDispatch, if_chain_actor, 8);
+BENCHMARK_TEMPLATE(BM_ActorDispatch, typed_msg_actor, 8);
+BENCHMARK_TEMPLATE(BM_ActorDispatch, if_chain_actor, 32);
+BENCHMARK_TEMPLATE(BM_ActorDispatch, typed_msg_actor, 32);
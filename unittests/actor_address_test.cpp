@@ -0,0 +1,86 @@
+#include <libyaaf/actor_address.h>
+
+#include "helpers.h"
+#include <catch.hpp>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("actor_address") {
+  yaaf::actor_address empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.get_pathname(), "");
+  EXPECT_EQ(yaaf::actor_address(yaaf::id_t(1)).get_pathname(), "null");
+
+  std::string path = "/root/usr/a";
+  yaaf::actor_address a1(yaaf::id_t(1), path);
+  yaaf::actor_address a2(yaaf::id_t(1), std::string("/root/usr/") + "a");
+  yaaf::actor_address b(yaaf::id_t(2), "/root/usr/b");
+
+  EXPECT_EQ(a1.get_pathname(), path);
+  // equal paths are interned to one handle.
+  EXPECT_TRUE(a1.get_path() == a2.get_path());
+  EXPECT_TRUE(a1 == a2);
+  EXPECT_TRUE(a1 != b);
+  EXPECT_EQ(std::hash<yaaf::actor_address>()(a1), std::hash<yaaf::actor_address>()(a2));
+
+  auto copy = a1;
+  EXPECT_TRUE(copy == a1);
+  EXPECT_EQ(std::to_string(copy), path);
+
+  SECTION("actor_address. interning from many threads") {
+    const size_t threads_count = 4;
+    const size_t paths_count = 1000;
+    std::vector<std::vector<uint64_t>> interned(threads_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; ++i) {
+      threads.emplace_back([i, &interned]() {
+        for (size_t j = 0; j < paths_count; ++j) {
+          yaaf::actor_address a(yaaf::id_t(j + 1), "/root/usr/" + std::to_string(j));
+          auto h = a.get_path();
+          interned[i].push_back((uint64_t(h.slot) << 32) | h.generation);
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    size_t different = 0;
+    for (size_t i = 1; i < threads_count; ++i) {
+      if (interned[i] != interned[0]) {
+        different++;
+      }
+    }
+    EXPECT_EQ(different, size_t(0));
+    std::unordered_set<uint64_t> unique(interned[0].begin(), interned[0].end());
+    EXPECT_EQ(unique.size(), paths_count);
+  }
+
+  SECTION("actor_address. a path is freed with its owner") {
+    auto before = yaaf::actor_address::interned();
+    yaaf::actor_address c;
+    {
+      yaaf::inner::path_owner owner;
+      owner.reset("/root/usr/c");
+      c = yaaf::actor_address(yaaf::id_t(3), owner);
+      EXPECT_EQ(yaaf::actor_address::interned(), before + 1);
+      auto c_copy = c;
+      EXPECT_TRUE(c == c_copy);
+      EXPECT_EQ(c_copy.get_pathname(), "/root/usr/c");
+    }
+    EXPECT_EQ(yaaf::actor_address::interned(), before);
+    // the actor is gone, its path is not resolved.
+    EXPECT_FALSE(c.empty());
+    EXPECT_EQ(c.get_pathname(), "");
+
+    // a reused slot does not resolve handles of the previous path.
+    for (size_t i = 0; i < 1000; ++i) {
+      yaaf::inner::path_owner owner;
+      owner.reset("/root/usr/" + std::to_string(i));
+      yaaf::actor_address d(yaaf::id_t(i + 1), owner);
+      EXPECT_EQ(d.get_pathname(), "/root/usr/" + std::to_string(i));
+      EXPECT_EQ(c.get_pathname(), "");
+    }
+    EXPECT_EQ(yaaf::actor_address::interned(), before);
+  }
+}
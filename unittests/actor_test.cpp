@@ -1,4 +1,5 @@
 #include <libyaaf/context.h>
+#include <libyaaf/typed_actor.h>
 
 #include "helpers.h"
 #include <catch.hpp>
@@ -65,4 +66,149 @@ TEST_CASE("actor. apply", "[actor]") {
     EXPECT_EQ(st.kind, yaaf::actor_status_kinds::NORMAL);
     EXPECT_EQ(st.msg, std::string());
   }
+
+  SECTION("actor. exception keeps not handled values in mailbox") {
+    mbox.push(int(1), yaaf::actor_address());
+    mbox.push(std::string("bad cast check"), yaaf::actor_address());
+    mbox.push(int(2), yaaf::actor_address());
+
+    EXPECT_TRUE(actor->try_lock());
+    EXPECT_THROWS(actor->apply(mbox));
+    EXPECT_EQ(summ, int(1));
+    EXPECT_EQ(mbox.size(), size_t(1));
+
+    EXPECT_TRUE(actor->try_lock());
+    actor->apply(mbox);
+    EXPECT_EQ(summ, int(1) + 2);
+    EXPECT_TRUE(mbox.empty());
+  }
+}
+
+TEST_CASE("actor. batch handler", "[actor]") {
+  class batch_actor final : public yaaf::base_actor {
+  public:
+    void action_handle(const yaaf::envelope &) override { single_calls++; }
+
+    void action_handle_batch(yaaf::envelope_span batch) override {
+      batches.push_back(batch.size());
+      for (auto &e : batch) {
+        summ += e.payload.cast<int>();
+      }
+    }
+
+    size_t single_calls = 0;
+    int summ = 0;
+    std::vector<size_t> batches;
+  };
+
+  auto actor = std::make_shared<batch_actor>();
+  auto settings = yaaf::actor_settings::defsettings();
+  settings.batch_size = 4;
+  actor->set_settings(settings);
+
+  yaaf::mpsc_mailbox mbox;
+  for (int i = 0; i < 10; ++i) {
+    mbox.push(i, yaaf::actor_address());
+  }
+
+  EXPECT_TRUE(actor->try_lock());
+  actor->apply(mbox);
+
+  EXPECT_TRUE(mbox.empty());
+  EXPECT_EQ(actor->single_calls, size_t(0));
+  EXPECT_EQ(actor->summ, int(45));
+  EXPECT_EQ(actor->batches, (std::vector<size_t>{4, 4, 2}));
+
+  SECTION("actor. batch handler exception drops the batch") {
+    mbox.push(std::string("bad cast check"), yaaf::actor_address());
+    mbox.push(int(1), yaaf::actor_address());
+    EXPECT_TRUE(actor->try_lock());
+    EXPECT_THROWS(actor->apply(mbox));
+    EXPECT_TRUE(mbox.empty());
+    EXPECT_FALSE(actor->busy());
+  }
+}
+
+TEST_CASE("actor. throughput quota", "[actor]") {
+  class counting_actor final : public yaaf::base_actor {
+  public:
+    void action_handle(const yaaf::envelope &) override { handled++; }
+    size_t handled = 0;
+  };
+
+  auto actor = std::make_shared<counting_actor>();
+  auto settings = yaaf::actor_settings::defsettings();
+  settings.batch_size = 4;
+  settings.throughput = 10;
+  actor->set_settings(settings);
+
+  yaaf::mpsc_mailbox mbox;
+  for (int i = 0; i < 25; ++i) {
+    mbox.push(i, yaaf::actor_address());
+  }
+
+  EXPECT_TRUE(actor->try_lock());
+  actor->apply(mbox);
+  EXPECT_EQ(actor->handled, size_t(10));
+  EXPECT_FALSE(mbox.empty());
+  EXPECT_FALSE(actor->busy());
+
+  EXPECT_TRUE(actor->try_lock());
+  actor->apply(mbox);
+  EXPECT_EQ(actor->handled, size_t(20));
+
+  EXPECT_TRUE(actor->try_lock());
+  actor->apply(mbox);
+  EXPECT_EQ(actor->handled, size_t(25));
+  EXPECT_TRUE(mbox.empty());
+}
+
+namespace {
+struct copies_counter {
+  copies_counter() = default;
+  copies_counter(const copies_counter &) { copies++; }
+  copies_counter(copies_counter &&) = default;
+  static size_t copies;
+};
+size_t copies_counter::copies = 0;
+
+class typed_test_actor final
+    : public yaaf::typed_actor<typed_test_actor, int, std::string, copies_counter> {
+public:
+  void on_message(const int &v, const yaaf::envelope &) { ints += v; }
+  void on_message(const std::string &v, const yaaf::envelope &) { strings += v; }
+  void on_message(const copies_counter &, const yaaf::envelope &) { counters++; }
+  void on_unhandled(const yaaf::envelope &) override { unhandled++; }
+
+  int ints = 0;
+  std::string strings;
+  size_t counters = 0;
+  size_t unhandled = 0;
+};
+} // namespace
+
+TEST_CASE("actor. typed dispatch", "[actor]") {
+  auto actor = std::make_shared<typed_test_actor>();
+  yaaf::mpsc_mailbox mbox;
+  mbox.push(int(1), yaaf::actor_address());
+  mbox.push(std::string("a"), yaaf::actor_address());
+  mbox.push(double(1.0), yaaf::actor_address());
+  mbox.push(int(2), yaaf::actor_address());
+  mbox.push(copies_counter(), yaaf::actor_address());
+
+  yaaf::envelope shared_e{yaaf::payload_t(std::string("b")), yaaf::actor_address()};
+  shared_e.payload.share();
+  mbox.push(std::move(shared_e));
+  mbox.push(yaaf::envelope{});
+
+  copies_counter::copies = 0;
+  EXPECT_TRUE(actor->try_lock());
+  actor->apply(mbox);
+
+  EXPECT_TRUE(mbox.empty());
+  EXPECT_EQ(actor->ints, int(3));
+  EXPECT_EQ(actor->strings, "ab");
+  EXPECT_EQ(actor->counters, size_t(1));
+  EXPECT_EQ(copies_counter::copies, size_t(0));
+  EXPECT_EQ(actor->unhandled, size_t(2));
 }
@@ -5,6 +5,7 @@
 
 #include <catch.hpp>
 #include <map>
+#include <set>
 
 using namespace yaaf;
 using namespace yaaf::utils::logging;
@@ -60,6 +61,746 @@ TEST_CASE("context. sending", "[context]") {
   ctx = nullptr;
 }
 
+TEST_CASE("context. actor registry", "[context]") {
+  yaaf::inner::actor_registry registry;
+  auto make_description = [](uint64_t id, const std::string &name) {
+    auto d = std::make_shared<yaaf::inner::description>();
+    d->name = name;
+    d->address = yaaf::actor_address(id, name);
+    return d;
+  };
+
+  const size_t count = yaaf::inner::actor_registry::shards_count * 3;
+  for (size_t i = 0; i < count; ++i) {
+    registry.insert(make_description(i, "/a" + std::to_string(i)));
+  }
+  EXPECT_EQ(registry.size(), count);
+  EXPECT_EQ(registry.find(yaaf::id_t(7))->name, "/a7");
+  EXPECT_EQ(registry.find("/a7")->address.get_id(), yaaf::id_t(7));
+  EXPECT_EQ(registry.find(yaaf::id_t(count)), nullptr);
+
+  // a new actor with the same name replaces the name index entry.
+  registry.insert(make_description(count, "/a7"));
+  EXPECT_EQ(registry.find("/a7")->address.get_id(), yaaf::id_t(count));
+  EXPECT_NE(registry.erase(yaaf::id_t(7)), nullptr);
+  EXPECT_EQ(registry.erase(yaaf::id_t(7)), nullptr);
+  EXPECT_EQ(registry.find("/a7")->address.get_id(), yaaf::id_t(count));
+  EXPECT_FALSE(registry.contains(yaaf::id_t(7)));
+
+  size_t visited = 0;
+  registry.for_each([&visited](const yaaf::inner::description_ptr &) { visited++; });
+  EXPECT_EQ(visited, count);
+
+  registry.clear();
+  EXPECT_EQ(registry.size(), size_t(0));
+  EXPECT_EQ(registry.find("/a1"), nullptr);
+}
+
+TEST_CASE("context. spawn while sending", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_size_t received = 0;
+  auto counter = [&received](yaaf::envelope) { received++; };
+  auto target = ctx->make_actor<yaaf::actor_for_delegate>("target", counter);
+
+  const size_t messages = 10000;
+  std::thread sender([ctx, target, messages]() {
+    for (size_t i = 0; i < messages; ++i) {
+      ctx->send(target, int(1));
+    }
+  });
+
+  std::vector<yaaf::actor_address> spawned;
+  for (size_t i = 0; i < 1000; ++i) {
+    spawned.push_back(ctx->make_actor<yaaf::actor_for_delegate>(
+        "spawned_" + std::to_string(i), [](yaaf::envelope) {}));
+  }
+  sender.join();
+
+  size_t not_found = 0;
+  for (auto &a : spawned) {
+    if (ctx->get_address(a.get_pathname()).get_id() != a.get_id()) {
+      not_found++;
+    }
+  }
+  EXPECT_EQ(not_found, size_t(0));
+  while (received.load() != messages) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ctx = nullptr;
+}
+
+TEST_CASE("context. actor_ref", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_int summ = 0;
+  auto c1 = [&summ](yaaf::envelope e) { summ += e.payload.cast<int>(); };
+  auto c1_addr = ctx->make_actor<yaaf::actor_for_delegate>("c1", c1);
+
+  auto ref = ctx->get_ref(c1_addr);
+  EXPECT_FALSE(ref.empty());
+  EXPECT_TRUE(ref.alive());
+  EXPECT_EQ(ref.address(), c1_addr);
+
+  SECTION("actor_ref. sending") {
+    for (int i = 1; i <= 10; ++i) {
+      ctx->send(ref, i);
+    }
+    while (summ.load() != 55) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  SECTION("actor_ref. to stopped actor") {
+    ctx->stop_actor(c1_addr);
+    EXPECT_FALSE(ref.alive());
+    EXPECT_EQ(ref.lock(), nullptr);
+    ctx->send(ref, int(1));
+    EXPECT_TRUE(ctx->get_ref(c1_addr).empty());
+  }
+
+  SECTION("actor_ref. from an actor") {
+    class forwarder final : public yaaf::base_actor {
+    public:
+      forwarder(yaaf::actor_ref target) : _target(target) {}
+      void action_handle(const yaaf::envelope &e) override {
+        get_context()->send(_target, e.payload.cast<int>());
+      }
+
+    private:
+      yaaf::actor_ref _target;
+    };
+    auto f_addr = ctx->make_actor<forwarder>("forwarder", ref);
+    ctx->send(f_addr, int(3));
+    while (summ.load() != 3) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  ctx = nullptr;
+}
+
+namespace {
+std::atomic_size_t message_allocations = 0;
+
+template <class T> struct counting_allocator {
+  using value_type = T;
+  counting_allocator() = default;
+  template <class U> counting_allocator(const counting_allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    message_allocations++;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  bool operator==(const counting_allocator &) const { return true; }
+  bool operator!=(const counting_allocator &) const { return false; }
+};
+
+struct counted_message {
+  std::vector<char, counting_allocator<char>> data =
+      std::vector<char, counting_allocator<char>>(128);
+};
+
+/// resends each int as a counted_message and a move-only value.
+class resender final : public yaaf::base_actor {
+public:
+  resender(yaaf::actor_address target) : _target(target) {}
+  void action_handle(const yaaf::envelope &e) override {
+    get_context()->send(_target, counted_message());
+    get_context()->send(_target, std::make_unique<int>(e.payload.cast<int>()));
+  }
+
+private:
+  yaaf::actor_address _target;
+};
+} // namespace
+
+TEST_CASE("context. send without copies", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_size_t counted = 0;
+  std::atomic_int summ = 0;
+  auto receiver = [&counted, &summ](const yaaf::envelope &e) {
+    if (e.payload.is<counted_message>()) {
+      counted++;
+    } else {
+      summ += *e.payload.get<std::unique_ptr<int>>();
+    }
+  };
+  auto target = ctx->make_actor<yaaf::actor_for_delegate>("target", receiver);
+  auto source = ctx->make_actor<resender>("resender", target);
+
+  message_allocations.store(0);
+  const int messages = 10;
+  for (int i = 1; i <= messages; ++i) {
+    ctx->send(source, i);
+  }
+  while (counted.load() != size_t(messages) || summ.load() != 55) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  // each message is constructed once and moved to the mailbox of the target.
+  EXPECT_EQ(message_allocations.load(), size_t(messages));
+  ctx = nullptr;
+}
+
+namespace {
+/// handles one envelope at a time and stalls on the first one until 'release'.
+class stalled_actor final : public yaaf::base_actor {
+public:
+  stalled_actor(yaaf::overflow_policy policy, yaaf::actor_address dead_letters,
+                std::atomic_bool *started, std::atomic_bool *release)
+      : _policy(policy), _dead_letters(dead_letters), _started(started),
+        _release(release) {}
+
+  yaaf::actor_settings on_init(const yaaf::actor_settings &base_settings) override {
+    auto result = base_settings;
+    result.batch_size = 1;
+    result.capacity = 10;
+    result.overflow = _policy;
+    result.block_timeout_us = 1000;
+    result.dead_letters = _dead_letters;
+    return result;
+  }
+
+  void action_handle(const yaaf::envelope &) override {
+    *_started = true;
+    while (!_release->load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+private:
+  yaaf::overflow_policy _policy;
+  yaaf::actor_address _dead_letters;
+  std::atomic_bool *_started;
+  std::atomic_bool *_release;
+};
+} // namespace
+
+TEST_CASE("context. bounded mailbox", "[context]") {
+  auto params = yaaf::context::params_t::defparams();
+  // the stalled actor takes one of threads.
+  params.user_threads = 2;
+  auto ctx = yaaf::context::make_context(params);
+
+  std::atomic_size_t notices = 0;
+  std::atomic_size_t dead_letters = 0;
+  yaaf::actor_address stalled_addr;
+  auto sender = [&notices, &stalled_addr](const yaaf::envelope &e) {
+    if (e.payload.is<yaaf::mailbox_overflow>() &&
+        e.payload.get<yaaf::mailbox_overflow>().target == stalled_addr) {
+      notices++;
+    }
+  };
+  auto collector = [&dead_letters, &stalled_addr](const yaaf::envelope &e) {
+    if (e.payload.is<yaaf::dead_letter>()) {
+      auto &dl = e.payload.get<yaaf::dead_letter>();
+      if (dl.target == stalled_addr && dl.e.payload.cast<int>() > 0) {
+        dead_letters++;
+      }
+    }
+  };
+  auto sender_addr = ctx->make_actor<yaaf::actor_for_delegate>("sender", sender);
+  auto collector_addr = ctx->make_actor<yaaf::actor_for_delegate>("collector", collector);
+
+  std::atomic_bool started = false;
+  std::atomic_bool release = false;
+  const size_t sends = 100;
+  const size_t capacity = 10;
+  auto fill = [&](yaaf::overflow_policy policy) {
+    stalled_addr = ctx->make_actor<stalled_actor>("stalled", policy, collector_addr,
+                                                  &started, &release);
+    ctx->send(stalled_addr, int(0));
+    while (!started.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (size_t i = 1; i <= sends; ++i) {
+      ctx->send_envelope(stalled_addr, yaaf::envelope{int(i), sender_addr});
+    }
+    return ctx->get_mailbox_counters(stalled_addr);
+  };
+
+  SECTION("bounded mailbox. drop newest") {
+    auto c = fill(yaaf::overflow_policy::DROP_NEWEST);
+    EXPECT_EQ(c.dropped_newest, sends - capacity);
+  }
+
+  SECTION("bounded mailbox. drop oldest") {
+    auto c = fill(yaaf::overflow_policy::DROP_OLDEST);
+    EXPECT_EQ(c.dropped_oldest, sends - capacity);
+  }
+
+  SECTION("bounded mailbox. reject") {
+    auto c = fill(yaaf::overflow_policy::REJECT);
+    EXPECT_EQ(c.rejected, sends - capacity);
+    while (notices.load() != sends - capacity) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  SECTION("bounded mailbox. block") {
+    auto c = fill(yaaf::overflow_policy::BLOCK);
+    EXPECT_EQ(c.blocked, sends - capacity);
+    EXPECT_EQ(c.block_timeouts, sends - capacity);
+    while (notices.load() != sends - capacity) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  SECTION("bounded mailbox. dead letter") {
+    auto c = fill(yaaf::overflow_policy::DEAD_LETTER);
+    EXPECT_EQ(c.dead_letters, sends - capacity);
+    while (dead_letters.load() != sends - capacity) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  release = true;
+  ctx = nullptr;
+}
+
+TEST_CASE("context. priority lanes", "[context]") {
+  class lanes_actor final : public yaaf::base_actor {
+  public:
+    lanes_actor(std::atomic_bool *started, std::atomic_bool *release,
+                std::vector<int> *order, std::atomic_size_t *handled)
+        : _started(started), _release(release), _order(order), _handled(handled) {}
+
+    yaaf::actor_settings on_init(const yaaf::actor_settings &base_settings) override {
+      auto result = base_settings;
+      result.priority_lanes = 2;
+      result.batch_size = 1;
+      return result;
+    }
+
+    void action_handle(const yaaf::envelope &e) override {
+      *_started = true;
+      while (!_release->load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      _order->push_back(e.payload.cast<int>());
+      (*_handled)++;
+    }
+
+  private:
+    std::atomic_bool *_started;
+    std::atomic_bool *_release;
+    std::vector<int> *_order;
+    std::atomic_size_t *_handled;
+  };
+
+  auto ctx = yaaf::context::make_context();
+  std::atomic_bool started = false;
+  std::atomic_bool release = false;
+  std::vector<int> order;
+  std::atomic_size_t handled = 0;
+  auto addr =
+      ctx->make_actor<lanes_actor>("lanes", &started, &release, &order, &handled);
+
+  ctx->send(addr, int(0));
+  while (!started.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const int messages = 100;
+  for (int i = 1; i <= messages; ++i) {
+    ctx->send(addr, i);
+  }
+  ctx->send(addr, int(-1), yaaf::system_priority);
+  release = true;
+
+  while (handled.load() != size_t(messages + 2)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // the control message is handled right after the current one.
+  EXPECT_EQ(order[0], 0);
+  EXPECT_EQ(order[1], -1);
+  EXPECT_EQ(order.back(), messages);
+  ctx = nullptr;
+}
+
+TEST_CASE("context. forwarding keeps the priority", "[context]") {
+  class forwarder final : public yaaf::base_actor {
+  public:
+    forwarder(yaaf::actor_address target) : _target(target) {}
+    void action_handle(const yaaf::envelope &e) override {
+      get_context()->send_envelope(_target, e);
+    }
+
+  private:
+    yaaf::actor_address _target;
+  };
+
+  auto ctx = yaaf::context::make_context();
+  std::mutex locker;
+  std::vector<yaaf::envelope> received;
+  auto target = ctx->make_actor<yaaf::actor_for_delegate>(
+      "target", [&locker, &received](const yaaf::envelope &e) {
+        std::lock_guard<std::mutex> lg(locker);
+        received.push_back(e);
+      });
+  auto fwd = ctx->make_actor<forwarder>("forwarder", target);
+
+  ctx->send(fwd, int(1), yaaf::system_priority);
+  ctx->send_envelope(fwd, yaaf::envelope{int(2), yaaf::actor_address(), 42, 3});
+  auto count = [&]() {
+    std::lock_guard<std::mutex> lg(locker);
+    return received.size();
+  };
+  while (count() != 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::sort(received.begin(), received.end(),
+            [](const yaaf::envelope &l, const yaaf::envelope &r) {
+              return l.payload.cast<int>() < r.payload.cast<int>();
+            });
+  EXPECT_EQ(received[0].priority, yaaf::system_priority);
+  EXPECT_TRUE(received[0].sender == fwd);
+  EXPECT_EQ(received[1].priority, uint8_t(3));
+  EXPECT_EQ(received[1].correlation_id, uint64_t(42));
+  EXPECT_TRUE(received[1].sender == fwd);
+  ctx = nullptr;
+}
+
+TEST_CASE("context. affinity", "[context]") {
+  class threads_actor final : public yaaf::base_actor {
+  public:
+    threads_actor(yaaf::actor_affinity affinity, std::atomic_size_t *handled)
+        : _affinity(affinity), _handled(handled) {}
+
+    yaaf::actor_settings on_init(const yaaf::actor_settings &base_settings) override {
+      auto result = base_settings;
+      result.affinity = _affinity;
+      return result;
+    }
+
+    void action_handle(const yaaf::envelope &) override {
+      threads.insert(std::this_thread::get_id());
+      (*_handled)++;
+    }
+
+    std::set<std::thread::id> threads;
+
+  private:
+    yaaf::actor_affinity _affinity;
+    std::atomic_size_t *_handled;
+  };
+
+  auto params = yaaf::context::params_t::defparams();
+  params.user_threads = 2;
+  params.user_queue = yaaf::utils::async::queue_kinds::WORK_STEALING;
+  auto ctx = yaaf::context::make_context(params);
+
+  std::atomic_size_t handled = 0;
+  auto dedicated = std::make_shared<threads_actor>(yaaf::actor_affinity::DEDICATED,
+                                                   &handled);
+  auto sticky =
+      std::make_shared<threads_actor>(yaaf::actor_affinity::STICKY, &handled);
+  auto shared = std::make_shared<threads_actor>(yaaf::actor_affinity::NONE, &handled);
+  auto dedicated_addr = ctx->add_actor("dedicated", dedicated);
+  auto sticky_addr = ctx->add_actor("sticky", sticky);
+  auto shared_addr = ctx->add_actor("shared", shared);
+
+  const size_t messages = 100;
+  for (size_t i = 0; i < messages; ++i) {
+    ctx->send(dedicated_addr, int(1));
+    ctx->send(sticky_addr, int(1));
+    ctx->send(shared_addr, int(1));
+  }
+  while (handled.load() != messages * 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_EQ(dedicated->threads.size(), size_t(1));
+  auto dedicated_thread = *dedicated->threads.begin();
+  EXPECT_EQ(shared->threads.count(dedicated_thread), size_t(0));
+  EXPECT_EQ(sticky->threads.count(dedicated_thread), size_t(0));
+
+  // the thread of a stopped actor is joined by the context.
+  ctx->stop_actor(dedicated_addr);
+  ctx->send(shared_addr, int(1));
+  while (handled.load() != messages * 3 + 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ctx = nullptr;
+}
+
+TEST_CASE("context. timers", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_int summ = 0;
+  std::atomic_size_t received = 0;
+  auto c1 = [&summ, &received](const yaaf::envelope &e) {
+    summ += e.payload.cast<int>();
+    received++;
+  };
+  auto c1_addr = ctx->make_actor<yaaf::actor_for_delegate>("c1", c1);
+
+  SECTION("timers. once") {
+    auto start = std::chrono::steady_clock::now();
+    auto h = ctx->schedule_once(c1_addr, std::chrono::milliseconds(50), int(3));
+    EXPECT_FALSE(h.empty());
+    auto cancelled = ctx->schedule_once(c1_addr, std::chrono::milliseconds(50), int(100));
+    EXPECT_TRUE(ctx->cancel_timer(cancelled));
+    while (received.load() != 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(summ.load(), 3);
+    EXPECT_FALSE(ctx->cancel_timer(h));
+  }
+
+  SECTION("timers. periodic") {
+    auto h = ctx->schedule_periodic(c1_addr, std::chrono::milliseconds(1),
+                                    std::chrono::milliseconds(5), int(1));
+    while (received.load() < 3) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(ctx->cancel_timer(h));
+    auto after_cancel = received.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // one shot may be already in flight.
+    EXPECT_LE(received.load(), after_cancel + 1);
+  }
+
+  SECTION("timers. from an actor") {
+    class timeouted final : public yaaf::base_actor {
+    public:
+      timeouted(std::atomic_size_t *timeouts) : _timeouts(timeouts) {}
+      void action_handle(const yaaf::envelope &e) override {
+        if (e.payload.is<std::string>()) {
+          (*_timeouts)++;
+        } else {
+          get_context()->schedule_once(address(), std::chrono::milliseconds(5),
+                                       std::string("timeout"));
+        }
+      }
+
+    private:
+      std::atomic_size_t *_timeouts;
+    };
+    std::atomic_size_t timeouts = 0;
+    auto addr = ctx->make_actor<timeouted>("timeouted", &timeouts);
+    ctx->send(addr, int(1));
+    ctx->send(addr, int(2));
+    while (timeouts.load() != 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  SECTION("timers. stopped target") {
+    ctx->schedule_periodic(c1_addr, std::chrono::milliseconds(1),
+                           std::chrono::milliseconds(1), int(1));
+    ctx->stop_actor(c1_addr);
+    auto h = ctx->schedule_once(c1_addr, std::chrono::milliseconds(1), int(1));
+    EXPECT_TRUE(h.empty());
+  }
+  ctx = nullptr;
+}
+
+TEST_CASE("context. ask", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  class echo final : public yaaf::base_actor {
+  public:
+    void action_handle(const yaaf::envelope &e) override {
+      get_context()->reply(e, e.payload.cast<int>() * 2);
+    }
+  };
+  class silent final : public yaaf::base_actor {
+  public:
+    void action_handle(const yaaf::envelope &) override {}
+  };
+  auto echo_addr = ctx->make_actor<echo>("echo");
+  auto silent_addr = ctx->make_actor<silent>("silent");
+  const auto timeout = std::chrono::milliseconds(10000);
+
+  SECTION("ask. future") {
+    auto f = ctx->ask<int>(echo_addr, int(21), timeout);
+    EXPECT_TRUE(f.valid());
+    EXPECT_EQ(f.get(), 42);
+
+    std::vector<yaaf::ask_future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+      futures.push_back(ctx->ask<int>(echo_addr, i, timeout));
+    }
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(futures[i].get(), i * 2);
+    }
+  }
+
+  SECTION("ask. callback") {
+    std::atomic_int summ = 0;
+    std::atomic_size_t replies = 0;
+    for (int i = 1; i <= 10; ++i) {
+      ctx->ask<int>(echo_addr, i, timeout, [&summ, &replies](const int *r) {
+        if (r != nullptr) {
+          summ += *r;
+        }
+        replies++;
+      });
+    }
+    while (replies.load() != 10) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(summ.load(), 110);
+  }
+
+  SECTION("ask. timeout") {
+    auto f = ctx->ask<int>(silent_addr, int(1), std::chrono::milliseconds(50));
+    EXPECT_FALSE(f.wait());
+    EXPECT_THROWS(f.get());
+
+    std::atomic_bool timed_out = false;
+    ctx->ask<int>(silent_addr, int(1), std::chrono::milliseconds(50),
+                  [&timed_out](const int *r) { timed_out = (r == nullptr); });
+    while (!timed_out.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  SECTION("ask. from an actor") {
+    std::atomic_int result = 0;
+    class asking final : public yaaf::base_actor {
+    public:
+      asking(yaaf::actor_address target, std::atomic_int *result)
+          : _target(target), _result(result) {}
+      void action_handle(const yaaf::envelope &e) override {
+        auto result = _result;
+        get_context()->ask<int>(_target, e.payload.cast<int>(),
+                                std::chrono::milliseconds(10000),
+                                [result](const int *r) { *result = *r; });
+      }
+
+    private:
+      yaaf::actor_address _target;
+      std::atomic_int *_result;
+    };
+    auto asking_addr = ctx->make_actor<asking>("asking", echo_addr, &result);
+    ctx->send(asking_addr, int(5));
+    while (result.load() != 10) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  SECTION("ask. a callback of an actor is called on its turn") {
+    std::atomic_int timeouts = 0;
+    std::atomic_int overlapped = 0;
+    class asking final : public yaaf::base_actor {
+    public:
+      asking(yaaf::actor_address target, std::atomic_int *timeouts,
+             std::atomic_int *overlapped)
+          : _target(target), _timeouts(timeouts), _overlapped(overlapped) {}
+      void action_handle(const yaaf::envelope &e) override {
+        get_context()->ask<int>(_target, e.payload.cast<int>(),
+                                std::chrono::milliseconds(5), [this](const int *r) {
+                                  if (_in_handler) {
+                                    (*_overlapped)++;
+                                  }
+                                  if (r == nullptr) {
+                                    (*_timeouts)++;
+                                  }
+                                });
+        // the request expires on a system thread while the handler works.
+        _in_handler = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        _in_handler = false;
+      }
+
+    private:
+      yaaf::actor_address _target;
+      std::atomic_int *_timeouts;
+      std::atomic_int *_overlapped;
+      bool _in_handler = false;
+    };
+    auto asking_addr =
+        ctx->make_actor<asking>("asking", silent_addr, &timeouts, &overlapped);
+    ctx->send(asking_addr, int(1));
+    ctx->send(asking_addr, int(2));
+    while (timeouts.load() != 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(overlapped.load(), 0);
+  }
+
+  SECTION("ask. a move-only reply to an actor") {
+    class unique_echo final : public yaaf::base_actor {
+    public:
+      void action_handle(const yaaf::envelope &e) override {
+        get_context()->reply(e, std::make_unique<int>(e.payload.cast<int>() * 2));
+      }
+    };
+    std::atomic_int result = 0;
+    class asking final : public yaaf::base_actor {
+    public:
+      asking(yaaf::actor_address target, std::atomic_int *result)
+          : _target(target), _result(result) {}
+      void action_handle(const yaaf::envelope &e) override {
+        auto result = _result;
+        get_context()->ask<std::unique_ptr<int>>(
+            _target, e.payload.cast<int>(), std::chrono::milliseconds(10000),
+            [result](const std::unique_ptr<int> *r) {
+              *result = r != nullptr ? **r : -1;
+            });
+      }
+
+    private:
+      yaaf::actor_address _target;
+      std::atomic_int *_result;
+    };
+    auto unique_addr = ctx->make_actor<unique_echo>("unique_echo");
+    auto asking_addr = ctx->make_actor<asking>("asking", unique_addr, &result);
+    ctx->send(asking_addr, int(7));
+    while (result.load() == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(result.load(), 14);
+  }
+
+  SECTION("ask. a plain reply goes to the sender") {
+    std::atomic_int result = 0;
+    auto receiver = [&result](const yaaf::envelope &e) {
+      result = e.payload.cast<int>();
+    };
+    auto receiver_addr = ctx->make_actor<yaaf::actor_for_delegate>("receiver", receiver);
+    ctx->send_envelope(echo_addr, yaaf::envelope{int(4), receiver_addr});
+    while (result.load() != 8) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  SECTION("ask. pending request on stop") {
+    auto f = ctx->ask<int>(silent_addr, int(1), timeout);
+    ctx->stop();
+    EXPECT_FALSE(f.wait());
+  }
+  ctx = nullptr;
+}
+
+TEST_CASE("ask. pool reuses states", "[context]") {
+  auto pool = std::make_shared<yaaf::inner::ask_pool>();
+  for (int i = 0; i < 1000; ++i) {
+    auto s = pool->acquire(std::chrono::milliseconds(10000), nullptr);
+    auto id = s->id;
+    EXPECT_TRUE(pool->complete(id, yaaf::payload_t(i)));
+    EXPECT_EQ(pool->wait(s.get()), yaaf::inner::ask_status::REPLIED);
+    EXPECT_EQ(s->value.cast<int>(), i);
+    // a late reply to a reused state is ignored.
+    EXPECT_FALSE(pool->complete(id, yaaf::payload_t(i)));
+  }
+  EXPECT_EQ(pool->capacity(), size_t(1));
+  EXPECT_EQ(pool->pending(), size_t(0));
+  // deadlines of completed requests do not wake the system thread.
+  EXPECT_TRUE(pool->next_deadline() == std::chrono::steady_clock::time_point::max());
+
+  auto s = pool->acquire(std::chrono::milliseconds(0), nullptr);
+  EXPECT_EQ(pool->expire(std::chrono::steady_clock::now()), size_t(1));
+  EXPECT_EQ(pool->wait(s.get()), yaaf::inner::ask_status::TIMEOUT);
+
+  // a reply by a shared payload, e.g. a received published one.
+  auto shared = pool->acquire(std::chrono::milliseconds(10000), nullptr);
+  yaaf::payload_t reply(std::string("published"));
+  reply.share();
+  EXPECT_TRUE(pool->complete(shared->id, std::move(reply)));
+  yaaf::ask_future<std::string> f(shared);
+  EXPECT_EQ(f.get(), "published");
+}
+
 TEST_CASE("context. actor_start_stop", "[context]") {
   class testable_actor final : public yaaf::base_actor {
   public:
@@ -463,6 +1204,35 @@ TEST_CASE("context. ping-pong", "[context]") {
     SECTION("context: ping-pong 10") { pingers_count = 10; }
   }
 
+  SECTION("context. ping-pong with mailbox scan scheduler") {
+    ctx_params = yaaf::context::params_t::defparams();
+    ctx_params.user_threads = 4;
+    ctx_params.scheduler = yaaf::scheduler_kinds::MAILBOX_SCAN;
+
+    SECTION("context: ping-pong 1") { pingers_count = 1; }
+    SECTION("context: ping-pong 5") { pingers_count = 5; }
+  }
+
+  SECTION("context. ping-pong with work-stealing user threads") {
+    ctx_params = yaaf::context::params_t::defparams();
+    ctx_params.user_threads = 4;
+    ctx_params.user_queue = yaaf::utils::async::queue_kinds::WORK_STEALING;
+
+    SECTION("context: ping-pong 1") { pingers_count = 1; }
+    SECTION("context: ping-pong 5") { pingers_count = 5; }
+    SECTION("context: ping-pong 10") { pingers_count = 10; }
+  }
+
+  SECTION("context. ping-pong with throughput quota") {
+    ctx_params = yaaf::context::params_t::defparams();
+    ctx_params.user_threads = 2;
+    ctx_params.actor_throughput = 1;
+    ctx_params.actor_time_quota_us = 1;
+
+    SECTION("context: ping-pong 1") { pingers_count = 1; }
+    SECTION("context: ping-pong 5") { pingers_count = 5; }
+  }
+
   auto ctx = yaaf::context::make_context(ctx_params);
 
   std::vector<yaaf::actor_address> pingers(pingers_count);
@@ -602,9 +1372,22 @@ TEST_CASE("context. ping-pong over exchange", "[context]") {
     SECTION("context: exhange 10") { pongers_count = 10; }
   }
 
+  SECTION("context. exhange with mailbox scan scheduler") {
+    ctx_params = yaaf::context::params_t::defparams();
+    ctx_params.scheduler = yaaf::scheduler_kinds::MAILBOX_SCAN;
+
+    SECTION("context: exhange 1") { pongers_count = 1; }
+    SECTION("context: exhange 5") { pongers_count = 5; }
+  }
+
   auto ctx = yaaf::context::make_context(ctx_params);
 
   yaaf::actor_address pinger_addr = ctx->make_actor<ping_actor>("ping");
+  // pong_actor::on_start expects the exchange, but on_start calls may run in parallel.
+  while (!ctx->exchange_exists(PP_ENAME)) {
+    logger_info("wait exchange creation");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
   std::vector<yaaf::actor_address> pongers(pongers_count);
   for (size_t i = 0; i < pongers_count; ++i) {
     pongers[i] = ctx->make_actor<pong_actor>("pong_" + std::to_string(i));
@@ -683,4 +1466,117 @@ TEST_CASE("context. ping-pong over exchange", "[context]") {
 
   ctx->stop();
   ctx = nullptr;
-}
\ No newline at end of file
+}
+
+TEST_CASE("context. topic exchanges", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::mutex locker;
+  std::map<std::string, std::vector<int>> received;
+  auto make_subscriber = [&](const std::string &name) {
+    auto f = [&locker, &received, name](yaaf::envelope e) {
+      std::lock_guard<std::mutex> lg(locker);
+      received[name].push_back(e.payload.cast<int>());
+    };
+    return ctx->make_actor<yaaf::actor_for_delegate>(name, f);
+  };
+  auto net = make_subscriber("net");
+  auto prices = make_subscriber("prices");
+  auto usd = make_subscriber("usd");
+
+  ctx->subscribe_to_exchange(net, "/root/net/*");
+  ctx->subscribe_to_exchange(prices, "/prices/#");
+  ctx->subscribe_to_exchange(usd, "/prices/usd");
+  // a pattern is not an exchange, a literal topic is.
+  EXPECT_FALSE(ctx->exchange_exists("/prices/#"));
+  EXPECT_TRUE(ctx->exchange_exists("/prices/usd"));
+
+  ctx->publish("/root/net/host:80", int(1));
+  ctx->publish("/prices/usd", int(2));
+  ctx->publish("/prices/eur/spot", int(3));
+  ctx->publish("/other", int(4));
+
+  auto count = [&]() {
+    std::lock_guard<std::mutex> lg(locker);
+    size_t result = 0;
+    for (auto &kv : received) {
+      result += kv.second.size();
+    }
+    return result;
+  };
+  while (count() != 4) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(count(), size_t(4));
+  EXPECT_EQ(received["net"], std::vector<int>{1});
+  EXPECT_EQ(received["prices"], (std::vector<int>{2, 3}));
+  EXPECT_EQ(received["usd"], std::vector<int>{2});
+  ctx = nullptr;
+}
+
+TEST_CASE("context. publish shares a value of many subscribers", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_size_t received{0};
+  std::atomic_size_t shared{0};
+  auto f = [&received, &shared](const yaaf::envelope &e) {
+    if (e.payload.is_shared()) {
+      shared++;
+    }
+    received++;
+  };
+  auto s1 = ctx->make_actor<yaaf::actor_for_delegate>("s1", f);
+  auto s2 = ctx->make_actor<yaaf::actor_for_delegate>("s2", f);
+
+  ctx->subscribe_to_exchange(s1, "/single");
+  ctx->publish("/single", std::string("value"));
+  while (received.load() != 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(shared.load(), size_t(0));
+
+  ctx->subscribe_to_exchange(s1, "/many");
+  ctx->subscribe_to_exchange(s2, "/many");
+  ctx->publish("/many", std::string("value"));
+  while (received.load() != 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(shared.load(), size_t(2));
+  ctx = nullptr;
+}
+
+TEST_CASE("context. unsubscribe from exchanges", "[context]") {
+  auto ctx = yaaf::context::make_context();
+  std::atomic_size_t received{0};
+  auto f = [&received](yaaf::envelope) { received++; };
+  auto owner = ctx->make_actor<yaaf::actor_for_delegate>("owner", f);
+  auto s1 = ctx->make_actor<yaaf::actor_for_delegate>("s1", f);
+  auto s2 = ctx->make_actor<yaaf::actor_for_delegate>("s2", f);
+
+  ctx->create_exchange(owner, "/topic");
+  ctx->subscribe_to_exchange(s1, "/topic");
+  ctx->subscribe_to_exchange(s2, "/#");
+
+  ctx->unsubscribe_from_exchange(s1, "/topic");
+  ctx->publish("/topic", int(1));
+  while (received.load() != 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(received.load(), size_t(1));
+
+  // the exchange of a stopped owner lives while it has subscribers.
+  ctx->subscribe_to_exchange(s1, "/topic");
+  ctx->stop_actor(owner);
+  EXPECT_TRUE(ctx->exchange_exists("/topic"));
+  // a stop removes subscriptions of the actor at once.
+  ctx->stop_actor(s1);
+  EXPECT_FALSE(ctx->exchange_exists("/topic"));
+
+  // a subscription to a missing exchange creates it, the subscriber is the owner.
+  ctx->subscribe_to_exchange(s2, "/other");
+  ctx->unsubscribe_from_exchange(s2, "/other");
+  EXPECT_TRUE(ctx->exchange_exists("/other"));
+  ctx->stop_actor(s2);
+  EXPECT_FALSE(ctx->exchange_exists("/other"));
+  ctx = nullptr;
+}
@@ -10,4 +10,5 @@
 #define EXPECT_LT(a, b) REQUIRE((a) < (b))
 #define EXPECT_LE(a, b) REQUIRE((a) <= (b))
 #define EXPECT_NE(a, b) REQUIRE((a) != (b))
-#define EXPECT_GE(a, b) REQUIRE((a) >= (b))
\ No newline at end of file
+#define EXPECT_GE(a, b) REQUIRE((a) >= (b))
+#define EXPECT_THROWS(a) REQUIRE_THROWS(a)
\ No newline at end of file
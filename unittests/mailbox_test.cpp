@@ -3,8 +3,11 @@
 #include "helpers.h"
 #include <catch.hpp>
 
-TEST_CASE("mailbox") {
-  yaaf::mailbox mbox;
+#include <thread>
+
+namespace {
+template <class MB> void check_mailbox() {
+  MB mbox;
   EXPECT_TRUE(mbox.empty());
 
   mbox.push(std::string("svalue"), yaaf::actor_address());
@@ -29,3 +32,229 @@ TEST_CASE("mailbox") {
   EXPECT_FALSE(mbox.try_pop(out_v));
   EXPECT_TRUE(mbox.empty());
 }
+
+template <class MB> void check_mailbox_drain() {
+  MB mbox;
+  for (int i = 0; i < 10; ++i) {
+    mbox.push(i, yaaf::actor_address());
+  }
+
+  std::vector<yaaf::envelope> out;
+  EXPECT_EQ(mbox.drain(out, 4), size_t(4));
+  EXPECT_EQ(mbox.size(), size_t(6));
+  EXPECT_EQ(out.size(), size_t(4));
+  EXPECT_EQ(out.front().payload.cast<int>(), int(0));
+  EXPECT_EQ(out.back().payload.cast<int>(), int(3));
+
+  mbox.push_front(yaaf::envelope_span(out).subspan(2));
+  EXPECT_EQ(mbox.size(), size_t(8));
+
+  out.clear();
+  EXPECT_EQ(mbox.drain(out, 100), size_t(8));
+  EXPECT_TRUE(mbox.empty());
+  for (size_t i = 0; i < out.size(); ++i) {
+    EXPECT_EQ(out[i].payload.cast<int>(), int(i + 2));
+  }
+  EXPECT_EQ(mbox.drain(out, 100), size_t(0));
+}
+
+template <class MB> void check_mailbox_producers(size_t producers) {
+  const int per_producer = 1000;
+  MB mbox;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < producers; ++i) {
+    threads.emplace_back([&mbox, per_producer]() {
+      for (int v = 0; v < per_producer; ++v) {
+        mbox.push(v, yaaf::actor_address());
+      }
+    });
+  }
+
+  size_t received = 0;
+  int summ = 0;
+  yaaf::envelope out_v;
+  while (received != producers * per_producer) {
+    if (mbox.try_pop(out_v)) {
+      summ += out_v.payload.cast<int>();
+      received++;
+    }
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  EXPECT_TRUE(mbox.empty());
+  EXPECT_EQ(summ, int(producers) * (per_producer - 1) * per_producer / 2);
+}
+} // namespace
+
+TEST_CASE("mailbox") {
+  check_mailbox<yaaf::mailbox>();
+}
+
+TEST_CASE("mailbox. mpsc") {
+  check_mailbox<yaaf::mpsc_mailbox>();
+}
+
+TEST_CASE("mailbox. drain") {
+  check_mailbox_drain<yaaf::mailbox>();
+  check_mailbox_drain<yaaf::mpsc_mailbox>();
+}
+
+TEST_CASE("mailbox. concurrent producers") {
+  size_t producers = 1;
+  SECTION("mailbox. 1 producer") { producers = 1; }
+  SECTION("mailbox. 4 producers") { producers = 4; }
+
+  check_mailbox_producers<yaaf::mailbox>(producers);
+  check_mailbox_producers<yaaf::mpsc_mailbox>(producers);
+}
+
+TEST_CASE("mailbox. bounded") {
+  using yaaf::overflow_policy;
+  auto make = [](overflow_policy policy, std::chrono::microseconds timeout) {
+    return yaaf::bounded_mailbox(std::make_shared<yaaf::mailbox>(), 2, policy, timeout);
+  };
+  auto offer = [](yaaf::abstract_mailbox &mbox, int v) {
+    yaaf::envelope e{v, yaaf::actor_address()};
+    auto result = mbox.offer(e);
+    // a not accepted envelope stays with the sender.
+    EXPECT_EQ(e.payload.empty(), result);
+    return result;
+  };
+  auto contents = [](yaaf::abstract_mailbox &mbox) {
+    std::vector<int> result;
+    yaaf::envelope e;
+    while (mbox.try_pop(e)) {
+      result.push_back(e.payload.cast<int>());
+    }
+    return result;
+  };
+  const auto timeout = std::chrono::milliseconds(10);
+
+  SECTION("bounded. drop newest") {
+    auto mbox = make(overflow_policy::DROP_NEWEST, timeout);
+    EXPECT_TRUE(offer(mbox, 1));
+    EXPECT_TRUE(offer(mbox, 2));
+    EXPECT_FALSE(offer(mbox, 3));
+    mbox.push(4, yaaf::actor_address());
+    EXPECT_EQ(mbox.size(), size_t(2));
+    EXPECT_EQ(mbox.counters().dropped_newest, size_t(2));
+    EXPECT_EQ(contents(mbox), (std::vector<int>{1, 2}));
+
+    // taken envelopes free places.
+    EXPECT_TRUE(offer(mbox, 5));
+    std::vector<yaaf::envelope> out;
+    EXPECT_EQ(mbox.drain(out, 10), size_t(1));
+    EXPECT_TRUE(offer(mbox, 6));
+    EXPECT_TRUE(offer(mbox, 7));
+    EXPECT_FALSE(offer(mbox, 8));
+  }
+
+  SECTION("bounded. drop oldest") {
+    auto mbox = make(overflow_policy::DROP_OLDEST, timeout);
+    for (int i = 1; i <= 5; ++i) {
+      EXPECT_TRUE(offer(mbox, i));
+    }
+    EXPECT_EQ(mbox.counters().dropped_oldest, size_t(3));
+    EXPECT_EQ(contents(mbox), (std::vector<int>{4, 5}));
+  }
+
+  SECTION("bounded. drop oldest keeps control messages") {
+    auto locked = make(overflow_policy::DROP_OLDEST, timeout);
+    yaaf::bounded_mailbox lanes(std::make_shared<yaaf::priority_mailbox>(
+                                    2, yaaf::mailbox_kinds::LOCKED),
+                                2, overflow_policy::DROP_OLDEST, timeout);
+    for (yaaf::abstract_mailbox *mbox : {(yaaf::abstract_mailbox *)&locked,
+                                         (yaaf::abstract_mailbox *)&lanes}) {
+      yaaf::envelope control{int(-1), yaaf::actor_address(), 0, yaaf::system_priority};
+      EXPECT_TRUE(mbox->offer(control));
+      EXPECT_TRUE(offer(*mbox, 1));
+      EXPECT_TRUE(offer(*mbox, 2));
+      EXPECT_EQ(mbox->counters().dropped_oldest, size_t(1));
+      EXPECT_EQ(contents(*mbox), (std::vector<int>{-1, 2}));
+    }
+  }
+
+  SECTION("bounded. reject") {
+    auto mbox = make(overflow_policy::REJECT, timeout);
+    offer(mbox, 1);
+    offer(mbox, 2);
+    EXPECT_FALSE(offer(mbox, 3));
+    EXPECT_EQ(mbox.counters().rejected, size_t(1));
+  }
+
+  SECTION("bounded. dead letter") {
+    auto mbox = make(overflow_policy::DEAD_LETTER, timeout);
+    offer(mbox, 1);
+    offer(mbox, 2);
+    EXPECT_FALSE(offer(mbox, 3));
+    EXPECT_EQ(mbox.counters().dead_letters, size_t(1));
+  }
+
+  SECTION("bounded. block") {
+    auto mbox = make(overflow_policy::BLOCK, timeout);
+    offer(mbox, 1);
+    offer(mbox, 2);
+    EXPECT_FALSE(offer(mbox, 3));
+    EXPECT_EQ(mbox.counters().blocked, size_t(1));
+    EXPECT_EQ(mbox.counters().block_timeouts, size_t(1));
+
+    auto blocking = make(overflow_policy::BLOCK, std::chrono::seconds(10));
+    offer(blocking, 1);
+    offer(blocking, 2);
+    std::thread consumer([&blocking]() {
+      while (blocking.counters().blocked == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      yaaf::envelope e;
+      blocking.try_pop(e);
+    });
+    EXPECT_TRUE(offer(blocking, 3));
+    consumer.join();
+    EXPECT_EQ(blocking.counters().block_timeouts, size_t(0));
+    EXPECT_EQ(contents(blocking), (std::vector<int>{2, 3}));
+  }
+}
+
+namespace {
+yaaf::envelope make_envelope(int v, uint8_t priority) {
+  return yaaf::envelope{v, yaaf::actor_address(), 0, priority};
+}
+} // namespace
+
+TEST_CASE("mailbox. priority") {
+  auto kind = yaaf::mailbox_kinds::MPSC;
+  SECTION("priority. mpsc lanes") { kind = yaaf::mailbox_kinds::MPSC; }
+  SECTION("priority. locked lanes") { kind = yaaf::mailbox_kinds::LOCKED; }
+
+  yaaf::priority_mailbox mbox(3, kind);
+  EXPECT_TRUE(mbox.empty());
+  for (int i = 1; i <= 3; ++i) {
+    mbox.push(make_envelope(i, 0));
+  }
+  mbox.push(make_envelope(10, 1));
+  mbox.push(make_envelope(20, yaaf::system_priority));
+  EXPECT_EQ(mbox.size(), size_t(5));
+
+  std::vector<yaaf::envelope> out;
+  EXPECT_EQ(mbox.drain(out, 2), size_t(2));
+  EXPECT_EQ(out[0].payload.cast<int>(), 20);
+  EXPECT_EQ(out[1].payload.cast<int>(), 10);
+
+  // a lower lane gets the rest of a batch.
+  mbox.push(make_envelope(11, 1));
+  EXPECT_EQ(mbox.drain(out, 3), size_t(3));
+  EXPECT_EQ(out[2].payload.cast<int>(), 11);
+  EXPECT_EQ(out[3].payload.cast<int>(), 1);
+  EXPECT_EQ(out[4].payload.cast<int>(), 2);
+
+  // returned envelopes go to the heads of their lanes.
+  mbox.push_front(yaaf::envelope_span(out).subspan(2));
+  std::vector<int> order;
+  yaaf::envelope e;
+  while (mbox.try_pop(e)) {
+    order.push_back(e.payload.cast<int>());
+  }
+  EXPECT_EQ(order, (std::vector<int>{11, 1, 2, 3}));
+  EXPECT_TRUE(mbox.empty());
+}
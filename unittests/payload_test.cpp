@@ -2,6 +2,9 @@
 
 #include "helpers.h"
 #include <catch.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
 
 TEST_CASE("payload") {
   yaaf::payload_t p;
@@ -60,3 +63,150 @@ TEST_CASE("payload") {
     }
   }
 }
+
+namespace {
+struct pod_value {
+  int a;
+  double b;
+  char name[16];
+};
+
+struct copy_counter {
+  copy_counter() = default;
+  copy_counter(const copy_counter &other) : copies(other.copies + 1) {}
+  copy_counter(copy_counter &&other) noexcept : copies(other.copies) {}
+  size_t copies = 0;
+};
+} // namespace
+
+TEST_CASE("payload. storage") {
+  SECTION("payload. trivially copyable value") {
+    pod_value v{1, 2.5, "pod"};
+    yaaf::payload_t p(v);
+    yaaf::payload_t cp(p);
+    EXPECT_TRUE(cp.is<pod_value>());
+    EXPECT_EQ(cp.get<pod_value>().a, 1);
+    EXPECT_EQ(cp.get<pod_value>().b, 2.5);
+    EXPECT_EQ(std::string(cp.get<pod_value>().name), std::string("pod"));
+
+    cp.get<pod_value>().a = 2;
+    EXPECT_EQ(p.get<pod_value>().a, 1);
+    EXPECT_EQ(cp.get<pod_value>().a, 2);
+  }
+
+  SECTION("payload. move does not copy a value") {
+    yaaf::payload_t p(copy_counter{});
+    EXPECT_EQ(p.get<copy_counter>().copies, size_t(0));
+
+    yaaf::payload_t mv(std::move(p));
+    EXPECT_TRUE(p.empty());
+    EXPECT_EQ(mv.get<copy_counter>().copies, size_t(0));
+
+    yaaf::payload_t assigned;
+    assigned = std::move(mv);
+    EXPECT_TRUE(mv.empty());
+    EXPECT_EQ(assigned.get<copy_counter>().copies, size_t(0));
+
+    yaaf::payload_t cp(assigned);
+    EXPECT_EQ(cp.get<copy_counter>().copies, size_t(1));
+  }
+
+  SECTION("payload. move-only value") {
+    yaaf::payload_t p(std::make_unique<std::string>("buffer"));
+    EXPECT_TRUE(p.is<std::unique_ptr<std::string>>());
+    EXPECT_EQ(*p.get<std::unique_ptr<std::string>>(), std::string("buffer"));
+
+    yaaf::payload_t mv(std::move(p));
+    EXPECT_TRUE(p.empty());
+    EXPECT_EQ(*mv.get<std::unique_ptr<std::string>>(), std::string("buffer"));
+
+    auto taken = std::move(mv.get<std::unique_ptr<std::string>>());
+    EXPECT_EQ(*taken, std::string("buffer"));
+
+    EXPECT_THROWS(yaaf::payload_t(mv));
+  }
+
+  SECTION("payload. bad cast") {
+    yaaf::payload_t p(int(1));
+    EXPECT_THROWS(p.cast<double>());
+    EXPECT_THROWS(p.get<std::string>());
+    yaaf::payload_t e;
+    EXPECT_THROWS(e.cast<int>());
+  }
+
+  SECTION("payload. self assignment and reset") {
+    yaaf::payload_t p(std::string("hello"));
+    auto &ref = p;
+    p = ref;
+    EXPECT_EQ(p.cast<std::string>(), std::string("hello"));
+    p.reset();
+    EXPECT_TRUE(p.empty());
+  }
+}
+
+TEST_CASE("payload. shared") {
+  SECTION("payload. shared heap value") {
+    yaaf::payload_t p(std::string("market data"));
+    auto value_addr = &p.get<std::string>();
+    p.share();
+    EXPECT_TRUE(p.is_shared());
+    EXPECT_EQ(&std::as_const(p).get<std::string>(), value_addr);
+
+    yaaf::payload_t cp(p);
+    EXPECT_TRUE(cp.is_shared());
+    EXPECT_TRUE(cp.is<std::string>());
+    EXPECT_FALSE(cp.is<int>());
+    EXPECT_EQ(&std::as_const(cp).get<std::string>(), value_addr);
+    EXPECT_EQ(cp.cast<std::string>(), std::string("market data"));
+    EXPECT_THROWS(cp.get<std::string>().clear());
+
+    p.reset();
+    EXPECT_EQ(cp.cast<std::string>(), std::string("market data"));
+
+    yaaf::payload_t mv(std::move(cp));
+    EXPECT_TRUE(cp.empty());
+    EXPECT_TRUE(mv.is_shared());
+    EXPECT_EQ(&std::as_const(mv).get<std::string>(), value_addr);
+  }
+
+  SECTION("payload. shared inline value") {
+    yaaf::payload_t p(int(7));
+    p.share();
+    p.share();
+    yaaf::payload_t cp;
+    cp = p;
+    EXPECT_EQ(cp.cast<int>(), int(7));
+    EXPECT_EQ(p.cast<int>(), int(7));
+  }
+
+  SECTION("payload. shared between threads") {
+    yaaf::payload_t p(std::string("fan-out"));
+    p.share();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([p]() {
+        for (size_t j = 0; j < 1000; ++j) {
+          yaaf::payload_t cp(p);
+          ENSURE(cp.cast<std::string>() == "fan-out");
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    EXPECT_EQ(p.cast<std::string>(), std::string("fan-out"));
+  }
+}
+
+TEST_CASE("payload. type index") {
+  yaaf::payload_t i(int(1));
+  yaaf::payload_t s(std::string("value"));
+  EXPECT_NE(i.type_index(), s.type_index());
+  EXPECT_EQ(i.type_index(), yaaf::payload_t::type_index_of<int>());
+  EXPECT_EQ(s.type_index(), yaaf::payload_t::type_index_of<const std::string &>());
+
+  auto shared = s;
+  shared.share();
+  EXPECT_EQ(shared.type_index(), s.type_index());
+  EXPECT_EQ(shared.get_unchecked<std::string>(), "value");
+}
@@ -0,0 +1,281 @@
+#include <libyaaf/context.h>
+
+#include "helpers.h"
+#include <catch.hpp>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace yaaf;
+
+namespace {
+/// envelopes handled by each routee.
+struct routed_t {
+  std::mutex locker;
+  std::map<std::string, std::vector<int>> by_routee;
+  std::atomic_size_t handled{0};
+};
+
+class routee_actor final : public base_actor {
+public:
+  explicit routee_actor(routed_t *routed) : _routed(routed) {}
+
+  void action_handle(const envelope &e) override {
+    {
+      std::lock_guard<std::mutex> lg(_routed->locker);
+      _routed->by_routee[address().get_pathname()].push_back(e.payload.cast<int>());
+    }
+    _routed->handled++;
+  }
+
+private:
+  routed_t *_routed;
+};
+
+void wait_handled(routed_t &routed, size_t count) {
+  while (routed.handled.load() != count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+/// routee of each key.
+std::map<int, std::string> owners(routed_t &routed) {
+  std::map<int, std::string> result;
+  for (auto &kv : routed.by_routee) {
+    for (auto v : kv.second) {
+      result[v] = kv.first;
+    }
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("router. round robin", "[router]") {
+  auto ctx = context::make_context();
+  routed_t routed;
+  router_settings settings;
+  settings.routees = 4;
+  auto router = ctx->make_router<routee_actor>("pool", settings, &routed);
+  EXPECT_EQ(ctx->get_routees(router).size(), size_t(4));
+
+  const int messages = 400;
+  for (int i = 0; i < messages; ++i) {
+    ctx->send(router, i);
+  }
+  wait_handled(routed, messages);
+  EXPECT_EQ(routed.by_routee.size(), size_t(4));
+  for (auto &kv : routed.by_routee) {
+    EXPECT_EQ(kv.second.size(), size_t(messages / 4));
+  }
+  ctx = nullptr;
+}
+
+TEST_CASE("router. random and smallest mailbox", "[router]") {
+  for (auto kind : {routing_kinds::RANDOM, routing_kinds::SMALLEST_MAILBOX}) {
+    auto ctx = context::make_context();
+    routed_t routed;
+    router_settings settings;
+    settings.kind = kind;
+    settings.routees = 3;
+    auto router = ctx->make_router<routee_actor>("pool", settings, &routed);
+    auto ref = ctx->get_ref(router);
+
+    const int messages = 300;
+    for (int i = 0; i < messages; ++i) {
+      ctx->send(ref, i);
+    }
+    wait_handled(routed, messages);
+    size_t total = 0;
+    for (auto &kv : routed.by_routee) {
+      total += kv.second.size();
+    }
+    EXPECT_EQ(total, size_t(messages));
+    EXPECT_GE(routed.by_routee.size(), size_t(2));
+    ctx = nullptr;
+  }
+}
+
+TEST_CASE("router. consistent hash", "[router]") {
+  auto ctx = context::make_context();
+  routed_t routed;
+  router_settings settings;
+  settings.kind = routing_kinds::CONSISTENT_HASH;
+  settings.routees = 4;
+  settings.key = [](const envelope &e) { return uint64_t(e.payload.cast<int>() % 100); };
+  auto router = ctx->make_router<routee_actor>("pool", settings, &routed);
+
+  // a key goes to one routee.
+  for (int i = 0; i < 1000; ++i) {
+    ctx->send(router, i);
+  }
+  wait_handled(routed, 1000);
+  std::map<int, std::string> owner_of_key;
+  for (auto &kv : routed.by_routee) {
+    for (auto v : kv.second) {
+      auto it = owner_of_key.emplace(v % 100, kv.first).first;
+      EXPECT_EQ(it->second, kv.first);
+    }
+  }
+  EXPECT_EQ(owner_of_key.size(), size_t(100));
+
+  // a new routee takes only a part of keys.
+  routed.by_routee.clear();
+  routed.handled = 0;
+  for (int i = 0; i < 100; ++i) {
+    ctx->send(router, i);
+  }
+  wait_handled(routed, 100);
+  auto before = owners(routed);
+
+  ctx->resize_router(router, 5);
+  EXPECT_EQ(ctx->get_routees(router).size(), size_t(5));
+  routed.by_routee.clear();
+  routed.handled = 0;
+  for (int i = 0; i < 100; ++i) {
+    ctx->send(router, i);
+  }
+  wait_handled(routed, 100);
+  auto after = owners(routed);
+  size_t moved = 0;
+  for (auto &kv : after) {
+    if (before[kv.first] != kv.second) {
+      ++moved;
+    }
+  }
+  EXPECT_GT(moved, size_t(0));
+  EXPECT_LT(moved, size_t(50));
+  ctx = nullptr;
+}
+
+TEST_CASE("router. shrink with queued envelopes", "[router]") {
+  class gated_routee final : public base_actor {
+  public:
+    gated_routee(routed_t *routed, std::atomic_bool *gate)
+        : _routed(routed), _gate(gate) {}
+
+    void action_handle(const envelope &e) override {
+      while (!_gate->load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      {
+        std::lock_guard<std::mutex> lg(_routed->locker);
+        _routed->by_routee[address().get_pathname()].push_back(e.payload.cast<int>());
+      }
+      _routed->handled++;
+    }
+
+  private:
+    routed_t *_routed;
+    std::atomic_bool *_gate;
+  };
+
+  auto ctx = context::make_context();
+  routed_t routed;
+  std::atomic_bool gate = false;
+  router_settings settings;
+  settings.routees = 4;
+  auto router = ctx->make_router<gated_routee>("pool", settings, &routed, &gate);
+
+  // the only user thread waits in the first routee, others queue their envelopes.
+  const int messages = 40;
+  for (int i = 0; i < messages; ++i) {
+    ctx->send(router, i);
+  }
+  ctx->resize_router(router, 1);
+  auto left = ctx->get_routees(router);
+  gate = true;
+
+  wait_handled(routed, messages);
+  EXPECT_EQ(routed.by_routee.size(), size_t(1));
+  EXPECT_EQ(routed.by_routee[left[0].get_pathname()].size(), size_t(messages));
+  ctx = nullptr;
+}
+
+TEST_CASE("router. shrink with dedicated routees", "[router]") {
+  class dedicated_routee final : public base_actor {
+  public:
+    dedicated_routee(routed_t *routed, std::atomic_bool *gate)
+        : _routed(routed), _gate(gate) {}
+
+    actor_settings on_init(const actor_settings &base_settings) override {
+      auto result = base_settings;
+      result.affinity = actor_affinity::DEDICATED;
+      return result;
+    }
+
+    void action_handle(const envelope &e) override {
+      while (!_gate->load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      {
+        std::lock_guard<std::mutex> lg(_routed->locker);
+        _routed->by_routee[address().get_pathname()].push_back(e.payload.cast<int>());
+      }
+      _routed->handled++;
+    }
+
+  private:
+    routed_t *_routed;
+    std::atomic_bool *_gate;
+  };
+
+  auto ctx = context::make_context();
+  routed_t routed;
+  std::atomic_bool gate = false;
+  router_settings settings;
+  settings.routees = 4;
+  auto router = ctx->make_router<dedicated_routee>("pool", settings, &routed, &gate);
+
+  // each routee waits in an own thread, the rest of its envelopes stays queued.
+  const int messages = 40;
+  for (int i = 0; i < messages; ++i) {
+    ctx->send(router, i);
+  }
+  ctx->resize_router(router, 1);
+  // the system thread stops retired threads while they wait the gate.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  gate = true;
+
+  wait_handled(routed, messages);
+  auto handled = owners(routed);
+  EXPECT_EQ(handled.size(), size_t(messages));
+  ctx = nullptr;
+}
+
+TEST_CASE("router. resize", "[router]") {
+  auto ctx = context::make_context();
+  routed_t routed;
+  router_settings settings;
+  settings.routees = 2;
+  auto router = ctx->make_router<routee_actor>("pool", settings, &routed);
+  auto first = ctx->get_routees(router);
+
+  ctx->resize_router(router, 4);
+  auto grown = ctx->get_routees(router);
+  EXPECT_EQ(grown.size(), size_t(4));
+  EXPECT_EQ(grown[0], first[0]);
+  EXPECT_EQ(grown[1], first[1]);
+
+  ctx->resize_router(router, 1);
+  auto shrunk = ctx->get_routees(router);
+  EXPECT_EQ(shrunk.size(), size_t(1));
+  EXPECT_TRUE(ctx->get_actor(grown[3]).lock() == nullptr);
+
+  // a stopped routee is replaced by a resize.
+  ctx->stop_actor(shrunk[0]);
+  ctx->resize_router(router, 1);
+  auto replaced = ctx->get_routees(router);
+  EXPECT_NE(replaced[0], shrunk[0]);
+
+  for (int i = 0; i < 10; ++i) {
+    ctx->send(router, i);
+  }
+  wait_handled(routed, 10);
+  EXPECT_EQ(routed.by_routee[replaced[0].get_pathname()].size(), size_t(10));
+
+  // routees are children of the router.
+  ctx->stop_actor(router);
+  EXPECT_TRUE(ctx->get_actor(replaced[0]).lock() == nullptr);
+  EXPECT_THROWS(ctx->resize_router(replaced[0], 2));
+  ctx = nullptr;
+}
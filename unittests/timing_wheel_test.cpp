@@ -0,0 +1,123 @@
+#include <libyaaf/timing_wheel.h>
+
+#include "helpers.h"
+#include <catch.hpp>
+#include <map>
+#include <vector>
+
+using yaaf::inner::timing_wheel;
+
+namespace {
+const auto tick = std::chrono::milliseconds(1);
+}
+
+TEST_CASE("timing_wheel") {
+  auto start = timing_wheel::clock::now();
+  timing_wheel wheel(tick, start);
+  yaaf::actor_ref target(yaaf::actor_address(yaaf::id_t(1), "/root/usr/a"), {});
+
+  std::vector<int> fired;
+  auto deliver = [&fired](const yaaf::actor_ref &, yaaf::envelope &&e) {
+    fired.push_back(e.payload.cast<int>());
+    return true;
+  };
+  auto at = [start](size_t ms) { return start + std::chrono::milliseconds(ms); };
+  auto schedule = [&](size_t ms, int v, size_t period_ms = 0) {
+    return wheel.schedule(target, yaaf::envelope{v, yaaf::actor_address()}, at(ms),
+                          std::chrono::milliseconds(period_ms));
+  };
+
+  SECTION("timing_wheel. once") {
+    auto h = schedule(10, 1);
+    EXPECT_FALSE(h.empty());
+    EXPECT_EQ(wheel.size(), size_t(1));
+
+    EXPECT_EQ(wheel.advance(at(9), deliver), size_t(0));
+    EXPECT_TRUE(fired.empty());
+    EXPECT_EQ(wheel.advance(at(10), deliver), size_t(1));
+    EXPECT_EQ(fired, std::vector<int>{1});
+    EXPECT_EQ(wheel.size(), size_t(0));
+    // a fired timer can't be cancelled.
+    EXPECT_FALSE(wheel.cancel(h));
+  }
+
+  SECTION("timing_wheel. cancel") {
+    auto h1 = schedule(10, 1);
+    auto h2 = schedule(10, 2);
+    EXPECT_TRUE(wheel.cancel(h1));
+    EXPECT_FALSE(wheel.cancel(h1));
+    EXPECT_FALSE(wheel.cancel(yaaf::timer_handle()));
+
+    // the slot of h1 is reused, the old handle must not cancel a new timer.
+    auto h3 = schedule(20, 3);
+    EXPECT_FALSE(wheel.cancel(h1));
+    wheel.advance(at(30), deliver);
+    EXPECT_EQ(fired, (std::vector<int>{2, 3}));
+    UNUSED(h2);
+    UNUSED(h3);
+  }
+
+  SECTION("timing_wheel. periodic") {
+    auto h = schedule(5, 1, 10);
+    wheel.advance(at(4), deliver);
+    EXPECT_TRUE(fired.empty());
+    wheel.advance(at(5), deliver);
+    EXPECT_EQ(fired.size(), size_t(1));
+    wheel.advance(at(25), deliver);
+    EXPECT_EQ(fired.size(), size_t(3));
+    EXPECT_TRUE(wheel.cancel(h));
+    wheel.advance(at(100), deliver);
+    EXPECT_EQ(fired.size(), size_t(3));
+  }
+
+  SECTION("timing_wheel. stopped target") {
+    auto dead = [&fired](const yaaf::actor_ref &, yaaf::envelope &&e) {
+      fired.push_back(e.payload.cast<int>());
+      return false;
+    };
+    auto h = schedule(1, 1, 1);
+    wheel.advance(at(1), dead);
+    EXPECT_EQ(fired.size(), size_t(1));
+    EXPECT_FALSE(wheel.cancel(h));
+    EXPECT_EQ(wheel.size(), size_t(0));
+  }
+
+  SECTION("timing_wheel. all levels") {
+    // deadlines on each level and on level borders, fired in order by steps.
+    std::multimap<size_t, int> expected;
+    std::vector<size_t> deadlines{1,      2,      255,     256,     257,
+                                  1000,   65535,  65536,   65537,   100000,
+                                  1 << 20, 1 << 24, (1 << 24) + 1, 50000000};
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+      schedule(deadlines[i], int(i));
+      expected.emplace(deadlines[i], int(i));
+    }
+    for (auto &kv : expected) {
+      fired.clear();
+      wheel.advance(at(kv.first - 1), deliver);
+      EXPECT_TRUE(fired.empty());
+      wheel.advance(at(kv.first), deliver);
+      EXPECT_EQ(fired, std::vector<int>{kv.second});
+    }
+    EXPECT_EQ(wheel.size(), size_t(0));
+  }
+
+  SECTION("timing_wheel. late advance") {
+    for (int i = 1; i <= 1000; ++i) {
+      schedule(size_t(i) * 7, i);
+    }
+    EXPECT_EQ(wheel.advance(at(7000), deliver), size_t(1000));
+    for (int i = 1; i <= 1000; ++i) {
+      EXPECT_EQ(fired[size_t(i) - 1], i);
+    }
+  }
+
+  SECTION("timing_wheel. a deadline in the past") {
+    wheel.advance(at(100), deliver);
+    schedule(50, 1);
+    wheel.advance(at(100), deliver);
+    EXPECT_TRUE(fired.empty());
+    wheel.advance(at(101), deliver);
+    EXPECT_EQ(fired, std::vector<int>{1});
+  }
+}
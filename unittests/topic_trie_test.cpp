@@ -0,0 +1,136 @@
+#include <libyaaf/topic_trie.h>
+
+#include "helpers.h"
+#include <algorithm>
+#include <catch.hpp>
+#include <vector>
+
+using yaaf::inner::topic_trie;
+
+namespace {
+yaaf::actor_ref ref(uint64_t id) {
+  return yaaf::actor_ref(yaaf::actor_address(yaaf::id_t(id), "/root/usr/a"), {});
+}
+
+std::vector<uint64_t> ids(const topic_trie::match_t &m) {
+  std::vector<uint64_t> result;
+  for (auto &r : *m) {
+    result.push_back(r.address().get_id().value);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("topic_trie") {
+  topic_trie trie;
+
+  SECTION("topic_trie. exact") {
+    EXPECT_TRUE(trie.subscribe("/prices/usd", ref(1)));
+    EXPECT_FALSE(trie.subscribe("/prices/usd", ref(1)));
+    EXPECT_TRUE(trie.subscribe("ping pong", ref(2)));
+    EXPECT_EQ(trie.size(), size_t(2));
+
+    EXPECT_EQ(ids(trie.match("/prices/usd")), std::vector<uint64_t>{1});
+    // empty segments are skipped.
+    EXPECT_EQ(ids(trie.match("prices//usd/")), std::vector<uint64_t>{1});
+    EXPECT_EQ(ids(trie.match("ping pong")), std::vector<uint64_t>{2});
+    EXPECT_TRUE(trie.match("/prices")->empty());
+    EXPECT_TRUE(trie.match("/prices/usd/spot")->empty());
+    EXPECT_EQ(trie.subscribers("/prices/usd").size(), size_t(1));
+    EXPECT_TRUE(trie.subscribers("/prices").empty());
+  }
+
+  SECTION("topic_trie. wildcards") {
+    EXPECT_FALSE(topic_trie::is_pattern("/root/net/host:80"));
+    EXPECT_TRUE(topic_trie::is_pattern("/root/net/*"));
+    EXPECT_TRUE(topic_trie::is_pattern("/prices/#"));
+
+    trie.subscribe("/root/net/*", ref(1));
+    trie.subscribe("/prices/#", ref(2));
+    trie.subscribe("/prices/*/spot", ref(3));
+    trie.subscribe("/#", ref(4));
+    trie.subscribe("/prices/usd/spot", ref(2));
+
+    EXPECT_EQ(ids(trie.match("/root/net/host:80")), (std::vector<uint64_t>{1, 4}));
+    EXPECT_EQ(ids(trie.match("/root/net")), (std::vector<uint64_t>{4}));
+    EXPECT_EQ(ids(trie.match("/root/net/a/b")), (std::vector<uint64_t>{4}));
+    // '#' matches zero segments too.
+    EXPECT_EQ(ids(trie.match("/prices")), (std::vector<uint64_t>{2, 4}));
+    // the subscriber of two matched patterns gets the envelope once.
+    EXPECT_EQ(ids(trie.match("/prices/usd/spot")), (std::vector<uint64_t>{2, 3, 4}));
+    EXPECT_EQ(ids(trie.match("/prices/usd/fwd")), (std::vector<uint64_t>{2, 4}));
+  }
+
+  SECTION("topic_trie. cache") {
+    trie.subscribe("/prices/*", ref(1));
+    auto m1 = trie.match("/prices/usd");
+    auto m2 = trie.match("/prices/usd");
+    EXPECT_EQ(m1.get(), m2.get());
+    EXPECT_EQ(trie.cached(), size_t(1));
+
+    // a change of subscriptions drops cached sets.
+    trie.subscribe("/prices/usd", ref(2));
+    EXPECT_EQ(trie.cached(), size_t(0));
+    EXPECT_EQ(ids(trie.match("/prices/usd")), (std::vector<uint64_t>{1, 2}));
+    EXPECT_EQ(ids(m1), std::vector<uint64_t>{1});
+
+    EXPECT_TRUE(trie.unsubscribe("/prices/*", yaaf::id_t(1)));
+    EXPECT_FALSE(trie.unsubscribe("/prices/*", yaaf::id_t(1)));
+    EXPECT_FALSE(trie.unsubscribe("/other", yaaf::id_t(1)));
+    EXPECT_EQ(ids(trie.match("/prices/usd")), std::vector<uint64_t>{2});
+
+    EXPECT_EQ(trie.erase("/prices/usd"), size_t(1));
+    EXPECT_TRUE(trie.match("/prices/usd")->empty());
+    EXPECT_EQ(trie.size(), size_t(0));
+  }
+
+  SECTION("topic_trie. scoped invalidation") {
+    const size_t count = 10;
+    for (size_t i = 0; i < count; ++i) {
+      trie.subscribe("/t" + std::to_string(i) + "/*", ref(i + 1));
+      trie.match("/t" + std::to_string(i) + "/x");
+    }
+    EXPECT_EQ(trie.cached(), count);
+
+    // a change stales sets of the first segment of its pattern, others are kept.
+    trie.subscribe("/t0/x", ref(count + 1));
+    EXPECT_LT(trie.cached(), count);
+    EXPECT_GT(trie.cached(), size_t(0));
+    EXPECT_EQ(ids(trie.match("/t0/x")), (std::vector<uint64_t>{1, count + 1}));
+
+    // a pattern from a wildcard may match any topic.
+    trie.subscribe("/#", ref(count + 2));
+    EXPECT_EQ(trie.cached(), size_t(0));
+    EXPECT_EQ(ids(trie.match("/t1/x")), (std::vector<uint64_t>{2, count + 2}));
+  }
+
+  SECTION("topic_trie. unsubscribe") {
+    trie.subscribe("/a/b/c", ref(1));
+    trie.subscribe("/a/*", ref(2));
+    auto nodes = trie.nodes();
+
+    // empty nodes are removed with the last subscriber.
+    EXPECT_TRUE(trie.unsubscribe("/a/b/c", yaaf::id_t(1)));
+    EXPECT_LT(trie.nodes(), nodes);
+    EXPECT_EQ(ids(trie.match("/a/b")), std::vector<uint64_t>{2});
+    EXPECT_TRUE(trie.unsubscribe("/a/*", yaaf::id_t(2)));
+    EXPECT_EQ(trie.nodes(), size_t(1));
+
+    // a big set is indexed, a removal keeps the rest of subscribers.
+    const uint64_t count = 100;
+    for (uint64_t i = 1; i <= count; ++i) {
+      EXPECT_TRUE(trie.subscribe("/big", ref(i)));
+    }
+    EXPECT_FALSE(trie.subscribe("/big", ref(50)));
+    for (uint64_t i = 1; i <= count; i += 2) {
+      EXPECT_TRUE(trie.unsubscribe("/big", yaaf::id_t(i)));
+      EXPECT_FALSE(trie.unsubscribe("/big", yaaf::id_t(i)));
+    }
+    EXPECT_EQ(trie.count("/big"), size_t(count / 2));
+    auto rest = ids(trie.match("/big"));
+    std::sort(rest.begin(), rest.end());
+    for (size_t i = 0; i < rest.size(); ++i) {
+      EXPECT_EQ(rest[i], uint64_t(i * 2 + 2));
+    }
+  }
+}
@@ -1,14 +1,19 @@
+#include <libyaaf/utils/async/idle_strategy.h>
 #include <libyaaf/utils/async/thread_manager.h>
 #include <libyaaf/utils/async/thread_pool.h>
 
+#include <libyaaf/utils/async_logger.h>
+#include <libyaaf/utils/logger.h>
 #include <libyaaf/utils/strings.h>
 #include <libyaaf/utils/utils.h>
 
 #include "helpers.h"
 #include <catch.hpp>
 
-#include <numeric>
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
 TEST_CASE("utils.split") {
 
   std::array<int, 8> tst_a;
@@ -40,6 +45,135 @@ TEST_CASE("utils.to_lower") {
   EXPECT_EQ(res, "upper string");
 }
 
+namespace {
+class counting_logger final : public yaaf::utils::logging::abstract_logger {
+public:
+  void message(yaaf::utils::logging::message_kind, const std::string &) noexcept override {
+    count++;
+  }
+  size_t count = 0;
+};
+
+struct formatted_counter {
+  size_t *calls;
+};
+
+std::string to_string(const formatted_counter &c) {
+  (*c.calls)++;
+  return "counter";
+}
+} // namespace
+
+TEST_CASE("utils.logger_level") {
+  using namespace yaaf::utils::logging;
+  auto raw_logger = new counting_logger();
+  abstract_logger_ptr l{raw_logger};
+  logger_manager::stop();
+  logger_manager::start(l);
+
+  size_t formatted = 0;
+  formatted_counter fc{&formatted};
+  EXPECT_EQ(logger_manager::level(), log_level::all);
+
+  logger_info("value: ", fc);
+  EXPECT_EQ(raw_logger->count, size_t(1));
+  EXPECT_EQ(formatted, size_t(1));
+
+  logger_manager::set_level(log_level::warn);
+  EXPECT_FALSE(logger_manager::enabled(message_kind::info));
+  EXPECT_TRUE(logger_manager::enabled(message_kind::warn));
+  logger("value: ", fc);
+  logger_info("value: ", fc);
+  EXPECT_EQ(raw_logger->count, size_t(1));
+  EXPECT_EQ(formatted, size_t(1));
+  logger_warn("value: ", fc);
+  EXPECT_EQ(raw_logger->count, size_t(2));
+  EXPECT_EQ(formatted, size_t(2));
+
+  logger_manager::set_level(log_level::off);
+  logger_fatal("value: ", fc);
+  EXPECT_EQ(raw_logger->count, size_t(2));
+  EXPECT_EQ(formatted, size_t(2));
+
+  logger_manager::set_level(log_level::all);
+}
+
+TEST_CASE("utils.async_file_logger") {
+  using namespace yaaf::utils::logging;
+  const std::string fname = "async_file_logger_test.log";
+  std::remove(fname.c_str());
+
+  const size_t threads_count = 4;
+  const size_t per_thread = 1000;
+  size_t written = 0;
+  size_t dropped = 0;
+
+  SECTION("async_file_logger. all records are written") {
+    auto params = async_file_logger::params_t::defparams(fname);
+    params.capacity = threads_count * per_thread;
+    params.batch_size = 64;
+    {
+      async_file_logger l(params);
+      EXPECT_TRUE(l.thread_safe());
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&l]() {
+          for (size_t j = 0; j < per_thread; ++j) {
+            l.message(message_kind::info, "record " + std::to_string(j));
+          }
+        });
+      }
+      for (auto &t : threads) {
+        t.join();
+      }
+      l.flush();
+      written = l.written();
+      dropped = l.dropped();
+    }
+    EXPECT_EQ(written, threads_count * per_thread);
+    EXPECT_EQ(dropped, size_t(0));
+  }
+
+  SECTION("async_file_logger. full ring drops records") {
+    auto params = async_file_logger::params_t::defparams(fname);
+    params.capacity = 4;
+    params.batch_size = 2;
+    {
+      async_file_logger l(params);
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&l]() {
+          for (size_t j = 0; j < per_thread; ++j) {
+            l.message(message_kind::warn, "record " + std::to_string(j));
+          }
+        });
+      }
+      for (auto &t : threads) {
+        t.join();
+      }
+      l.flush();
+      written = l.written();
+      dropped = l.dropped();
+    }
+    EXPECT_EQ(written + dropped, threads_count * per_thread);
+  }
+
+  std::ifstream in(fname);
+  size_t lines = 0;
+  size_t bad_lines = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.find("] record ") != 4) {
+      bad_lines++;
+    }
+    lines++;
+  }
+  EXPECT_EQ(lines, written);
+  EXPECT_EQ(bad_lines, size_t(0));
+  in.close();
+  std::remove(fname.c_str());
+}
+
 TEST_CASE("utils.threads_pool") {
   using namespace yaaf::utils::async;
 
@@ -95,6 +229,128 @@ TEST_CASE("utils.threads_pool") {
   }
 }
 
+TEST_CASE("utils.threads_pool. work stealing") {
+  using namespace yaaf::utils::async;
+
+  const thread_kind_t tk = 1;
+  const size_t threads_count = 4;
+  threads_pool tp(threads_pool::params_t(threads_count, tk, queue_kinds::WORK_STEALING));
+  EXPECT_EQ(tp.threads_count(), threads_count);
+
+  SECTION("work stealing. tasks from outside") {
+    std::atomic_size_t called = 0;
+    task at = [tk, &called](const thread_info &ti) {
+      if (tk != ti.kind) {
+        throw MAKE_EXCEPTION("(tk != ti.kind)");
+      }
+      called++;
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    const size_t tasks_count = 1000;
+    for (size_t i = 0; i < tasks_count; ++i) {
+      tp.post(wrap_task(at));
+    }
+    tp.flush();
+    EXPECT_EQ(called.load(), tasks_count);
+
+    auto lock = tp.post(wrap_task(at));
+    lock->wait();
+    EXPECT_EQ(called.load(), tasks_count + 1);
+  }
+
+  SECTION("work stealing. tasks from workers") {
+    std::atomic_size_t called = 0;
+    std::vector<size_t> threads(threads_count);
+    task leaf = [&called, &threads](const thread_info &ti) {
+      called++;
+      threads[ti.thread_number]++;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    const size_t leafs_count = 200;
+    task root = [&tp, &leaf, leafs_count](const thread_info &) {
+      for (size_t i = 0; i < leafs_count; ++i) {
+        tp.post(wrap_task(leaf));
+      }
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    tp.post(wrap_task(root))->wait();
+    tp.flush();
+    EXPECT_EQ(called.load(), leafs_count);
+    // all tasks were posted to one local deque, other threads must steal them.
+    auto busy_threads = std::count_if(threads.begin(), threads.end(),
+                                      [](size_t v) { return v != 0; });
+    EXPECT_GE(busy_threads, 2);
+  }
+
+  SECTION("work stealing. repeated tasks") {
+    size_t called = 0;
+    task at_while = [&called](const thread_info &) {
+      if (called < 10) {
+        ++called;
+        return CONTINUATION_STRATEGY::REPEAT;
+      }
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    tp.post(wrap_task(at_while))->wait();
+    EXPECT_EQ(called, size_t(10));
+  }
+
+  tp.stop();
+  EXPECT_TRUE(tp.is_stopped());
+}
+
+TEST_CASE("utils.threads_pool. affinity") {
+  using namespace yaaf::utils::async;
+
+  const thread_kind_t tk = 1;
+  const size_t threads_count = 3;
+  threads_pool tp(threads_pool::params_t(threads_count, tk, queue_kinds::WORK_STEALING));
+
+  SECTION("affinity. an idle worker runs own tasks") {
+    std::vector<size_t> threads;
+    task at = [&threads](const thread_info &ti) {
+      threads.push_back(ti.thread_number);
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    for (size_t i = 0; i < 20; ++i) {
+      tp.post(wrap_task(at), 1)->wait();
+      // the worker is idle again.
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(threads.size(), size_t(20));
+    EXPECT_TRUE(
+        std::all_of(threads.begin(), threads.end(), [](size_t v) { return v == 1; }));
+  }
+
+  SECTION("affinity. tasks of a busy worker are stolen") {
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+    task blocker = [&started, &release](const thread_info &) {
+      started = true;
+      while (!release.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    size_t thief = 1;
+    task at = [&thief](const thread_info &ti) {
+      thief = ti.thread_number;
+      return CONTINUATION_STRATEGY::SINGLE;
+    };
+    auto blocked = tp.post(wrap_task(blocker), 1);
+    while (!started.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    tp.post(wrap_task(at), 1)->wait();
+    EXPECT_NE(thief, size_t(1));
+    release = true;
+    blocked->wait();
+  }
+
+  tp.stop();
+}
+
 TEST_CASE("utils.threads_manager") {
   using namespace yaaf::utils::async;
 
@@ -151,3 +407,49 @@ TEST_CASE("utils.threads_manager") {
     t_manager.flush();
   }
 }
+
+TEST_CASE("utils.idle_strategy") {
+  using namespace yaaf::utils::async;
+  using clock = idle_strategy::clock;
+
+  auto no_work = []() { return false; };
+  idle_strategy idle(2, std::chrono::seconds(10));
+
+  // spins do not sleep.
+  idle.idle(clock::time_point::max(), no_work);
+  idle.idle(clock::time_point::max(), no_work);
+  EXPECT_EQ(idle.parks(), size_t(0));
+
+  SECTION("idle_strategy. deadline") {
+    auto start = clock::now();
+    idle.idle(start + std::chrono::milliseconds(20), no_work);
+    EXPECT_EQ(idle.parks(), size_t(1));
+    EXPECT_GE(clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(10));
+  }
+
+  SECTION("idle_strategy. pending work") {
+    idle.idle(clock::time_point::max(), []() { return true; });
+    EXPECT_EQ(idle.parks(), size_t(0));
+  }
+
+  SECTION("idle_strategy. notify") {
+    std::atomic_bool parked = false;
+    std::thread worker([&]() {
+      idle.idle(clock::time_point::max(), no_work);
+      parked = true;
+    });
+    while (idle.parks() == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    idle.notify();
+    worker.join();
+    EXPECT_TRUE(parked.load());
+  }
+
+  SECTION("idle_strategy. stop") {
+    idle.stop();
+    idle.idle(clock::time_point::max(), no_work);
+    EXPECT_EQ(idle.parks(), size_t(0));
+  }
+}